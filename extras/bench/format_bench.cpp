@@ -0,0 +1,145 @@
+/**
+ * format_bench.cpp
+ *
+ * Created: 18/10/2026
+ * Author: SCHAAF Hugo
+ * Rev : 0
+ *
+ * Host benchmark of the DateTime formatters and parsers of rtc_common.hpp
+ * against snprintf(), strftime(), sscanf() and strptime(). Every output is
+ * first checked against the libc one, then each function is timed on the
+ * same set of dates.
+ *
+ * Build (from this directory) :
+ *
+ *	g++ -std=c++11 -O2 -I../.. format_bench.cpp -o format_bench
+ *
+ * Usage :
+ *
+ *	format_bench [iterations]
+ *
+ * The exit status is 0 if every output matches the libc one, 1 otherwise.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "rtc_common.hpp"
+
+using namespace RTC;
+
+#define DATES   4096    // number of distinct dates formatted per iteration
+
+static volatile uint32_t sink; // keeps the results alive
+
+/**
+ * @brief      Time a function over all the dates.
+ *
+ * @return     The mean duration of one call in ns.
+ */
+template<class F>
+static double bench(const std::vector<DateTime> &dates, unsigned long iterations, F f)
+{
+	auto t0 = std::chrono::steady_clock::now();
+	for(unsigned long it=0; it < iterations; it++)
+	{
+		for(const DateTime &dt : dates) f(dt);
+	}
+	auto t1 = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(t1 - t0).count() / (iterations * dates.size());
+}
+
+static void toTm(const DateTime &dt, struct tm &tm)
+{
+	memset(&tm, 0, sizeof(tm));
+	tm.tm_sec  = dt.sec;
+	tm.tm_min  = dt.min;
+	tm.tm_hour = dt.hour;
+	tm.tm_mday = dt.day;
+	tm.tm_wday = dt.wday;
+	tm.tm_mon  = dt.mon - 1;
+	tm.tm_year = dt.year + 100;
+}
+
+int main(int argc, char** argv)
+{
+	unsigned long iterations = (argc > 1) ? strtoul(argv[1], nullptr, 0) : 200;
+	std::vector<DateTime> dates(DATES);
+	std::vector<std::string> iso(DATES);
+	size_t mismatches = 0;
+
+	// pseudo random dates over 2000-2099
+	srand(1);
+	for(DateTime &dt : dates)
+	{
+		from_epoch(EPOCH_2000 + (uint32_t)(((uint64_t)rand() << 16 ^ rand()) % (36524ULL * SECONDS_PER_DAY)), dt);
+	}
+
+	// correctness against the libc
+	for(size_t i=0; i < dates.size(); i++)
+	{
+		char ref[32], buf[32];
+		struct tm tm;
+		DateTime back;
+		int16_t off = 0;
+
+		toTm(dates[i], tm);
+		strftime(ref, sizeof(ref), "%Y-%m-%dT%H:%M:%SZ", &tm);
+		format_iso8601(dates[i], buf);
+		if(strcmp(ref, buf)) mismatches++;
+		iso[i] = buf;
+
+		strftime(ref, sizeof(ref), "%Y%m%dT%H%M%SZ", &tm);
+		format_compact(dates[i], buf);
+		if(strcmp(ref, buf)) mismatches++;
+
+		strftime(ref, sizeof(ref), "%Y-%m-%dT%H:%M:%S-05:30", &tm);
+		format_rfc3339(dates[i], -330, buf);
+		if(strcmp(ref, buf)) mismatches++;
+
+		if(parse_iso8601(buf, back, &off) != RFC3339_LEN || off != -330 || memcmp(&back, &dates[i], sizeof(back))) mismatches++;
+	}
+	printf("%zu dates checked against strftime, %zu mismatches\n\n", dates.size(), mismatches);
+
+	// formatting
+	char out[32];
+	double t_iso = bench(dates, iterations, [&](const DateTime &dt) { sink += format_iso8601(dt, out); });
+	double t_compact = bench(dates, iterations, [&](const DateTime &dt) { sink += format_compact(dt, out); });
+	double t_snprintf = bench(dates, iterations, [&](const DateTime &dt) {
+		sink += snprintf(out, sizeof(out), "20%02u-%02u-%02uT%02u:%02u:%02uZ", dt.year, dt.mon, dt.day, dt.hour, dt.min, dt.sec);
+	});
+	double t_strftime = bench(dates, iterations, [&](const DateTime &dt) {
+		struct tm tm;
+		toTm(dt, tm);
+		sink += strftime(out, sizeof(out), "%Y-%m-%dT%H:%M:%SZ", &tm);
+	});
+
+	// parsing, same strings for every parser
+	size_t next = 0;
+	auto str = [&]() -> const char* { const char* s = iso[next].c_str(); next = (next + 1) % iso.size(); return s; };
+	double t_parse = bench(dates, iterations, [&](const DateTime&) { DateTime dt; sink += parse_iso8601(str(), dt); });
+	double t_sscanf = bench(dates, iterations, [&](const DateTime&) {
+		unsigned y, mo, d, h, mi, s;
+		sink += sscanf(str(), "%4u-%2u-%2uT%2u:%2u:%2uZ", &y, &mo, &d, &h, &mi, &s);
+	});
+	double t_strptime = bench(dates, iterations, [&](const DateTime&) {
+		struct tm tm;
+		sink += (strptime(str(), "%Y-%m-%dT%H:%M:%SZ", &tm) != nullptr);
+	});
+
+	printf("%-16s %10s\n", "function", "ns/call");
+	printf("%-16s %10.1f\n", "format_iso8601", t_iso);
+	printf("%-16s %10.1f\n", "format_compact", t_compact);
+	printf("%-16s %10.1f\n", "snprintf", t_snprintf);
+	printf("%-16s %10.1f\n", "strftime", t_strftime);
+	printf("%-16s %10.1f\n", "parse_iso8601", t_parse);
+	printf("%-16s %10.1f\n", "sscanf", t_sscanf);
+	printf("%-16s %10.1f\n", "strptime", t_strptime);
+
+	return mismatches ? 1 : 0;
+}
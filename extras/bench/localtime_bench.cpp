@@ -0,0 +1,150 @@
+/**
+ * localtime_bench.cpp
+ *
+ * Created: 18/10/2026
+ * Author: SCHAAF Hugo
+ * Rev : 0
+ *
+ * Host comparison of RTC::TimeZone against the libc localtime_r(). For
+ * each time zone, TimeZone::toLocal() is checked against localtime_r()
+ * over 2000-2099, edges included where it must reject the instants whose
+ * local time is out of this range, then TimeZone::offset(), TimeZone::toLocal() and
+ * localtime_r() are timed on the same instants, taken within the
+ * transitions table (see RTC_TZ_FIRST_YEAR and RTC_TZ_YEARS).
+ *
+ * Build (from this directory) :
+ *
+ *	g++ -std=c++11 -O2 -I../.. localtime_bench.cpp ../../rtc_localtime.cpp -o localtime_bench
+ *
+ * Usage :
+ *
+ *	localtime_bench [TZ...]
+ *
+ * Without any argument, a set of zones covering both hemispheres, non
+ * whole hour offsets and extended transition times is used. Note that the
+ * libc may apply historic rules from tzdata to a TZ string without rules
+ * (e.g. "PST8PDT"), which then differ from the POSIX default rules.
+ *
+ * The exit status is 0 if every conversion matches localtime_r(), 1 otherwise.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+
+#include "rtc_localtime.hpp"
+
+using namespace RTC;
+
+#define SAMPLES     65536   // number of instants timed per zone
+
+static volatile uint32_t sink; // keeps the results alive
+
+/**
+ * @brief      Time a function over all the instants.
+ *
+ * @return     The mean duration of one call in ns.
+ */
+template<class F>
+static double bench(const std::vector<uint32_t> &instants, F f)
+{
+	auto t0 = std::chrono::steady_clock::now();
+	for(uint32_t t : instants) f(t);
+	auto t1 = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(t1 - t0).count() / instants.size();
+}
+
+int main(int argc, char** argv)
+{
+	static const char* const defaults[] = {
+		"UTC0",
+		"CET-1CEST,M3.5.0,M10.5.0/3",
+		"EST5EDT,M3.2.0,M11.1.0",
+		"AEST-10AEDT,M10.1.0,M4.1.0/3",
+		"NZST-12NZDT,M9.5.0,M4.1.0/3",
+		"<+0545>-5:45",
+		"<-03>3<-02>,M3.5.0/-2,M10.5.0/-1",
+		"IST-2IDT,M3.4.4/26,M10.5.0",
+	};
+	std::vector<const char*> zones(argv + 1, argv + argc);
+	std::vector<uint32_t> instants(SAMPLES);
+	size_t total_mismatches = 0;
+
+	if(zones.empty()) zones.assign(defaults, defaults + sizeof(defaults) / sizeof(defaults[0]));
+
+	// pseudo random instants within the transitions table
+	uint32_t first = EPOCH_2000 + days_from_civil(RTC_TZ_FIRST_YEAR, 1, 1) * SECONDS_PER_DAY;
+	uint32_t span = (days_from_civil(RTC_TZ_FIRST_YEAR + RTC_TZ_YEARS - 1, 12, 31) - days_from_civil(RTC_TZ_FIRST_YEAR, 1, 1)) * SECONDS_PER_DAY;
+	srand(1);
+	for(uint32_t &t : instants)
+	{
+		t = first + (uint32_t)(((uint64_t)rand() << 16 ^ rand()) % span);
+	}
+
+	printf("%-36s %9s %9s %11s %11s %15s\n", "zone", "checked", "mismatch", "offset ns", "toLocal ns", "localtime_r ns");
+	for(const char* zone : zones)
+	{
+		TimeZone tz;
+		size_t checked = 0, mismatches = 0;
+
+		if(tz.begin(zone))
+		{
+			printf("%-36s invalid TZ string\n", zone);
+			total_mismatches++;
+			continue;
+		}
+		setenv("TZ", zone, 1);
+		tzset();
+
+		auto check = [&](uint32_t t) {
+			time_t tt = t;
+			struct tm tm;
+			DateTime utc, local = {};
+			int16_t off = 0;
+
+			localtime_r(&tt, &tm);
+			from_epoch(t, utc);
+			int err = tz.toLocal(utc, local, &off);
+			bool in_range = tm.tm_year >= 100 && tm.tm_year <= 199;
+			checked++;
+			if(!in_range ? err != -1 :
+			   err || local.sec != tm.tm_sec || local.min != tm.tm_min || local.hour != tm.tm_hour
+			   || local.day != tm.tm_mday || local.mon != tm.tm_mon + 1 || local.year != tm.tm_year - 100
+			   || local.wday != tm.tm_wday || off * 60 != tm.tm_gmtoff)
+			{
+				if(!mismatches) printf("  first mismatch at %lu : %02u:%02u vs %02d:%02d\n", (unsigned long)t, local.hour, local.min, tm.tm_hour, tm.tm_min);
+				mismatches++;
+			}
+		};
+
+		// correctness, every ~30 minutes over 2000-2099, shifted to hit all minutes
+		for(uint32_t t = EPOCH_2000; t < EPOCH_2100; t += 1799 + (t % 7)) check(t);
+		// every minute of the first and last days, where the local time may leave the range
+		for(uint32_t t = EPOCH_2000; t < EPOCH_2000 + SECONDS_PER_DAY; t += 60) check(t);
+		for(uint32_t t = EPOCH_2100 - SECONDS_PER_DAY; t < EPOCH_2100; t += 60) check(t);
+		check(EPOCH_2100 - 1);
+
+		// timing, on the same instants for all
+		double t_offset = bench(instants, [&](uint32_t t) { sink += tz.offset(t); });
+		// from a Unix time, like localtime_r()
+		double t_tz = bench(instants, [&](uint32_t t) {
+			DateTime utc, local;
+			from_epoch(t, utc);
+			tz.toLocal(utc, local);
+			sink += local.hour;
+		});
+		double t_libc = bench(instants, [&](uint32_t t) {
+			time_t tt = t;
+			struct tm tm;
+			localtime_r(&tt, &tm);
+			sink += tm.tm_hour;
+		});
+
+		printf("%-36s %9zu %9zu %11.1f %11.1f %15.1f\n", zone, checked, mismatches, t_offset, t_tz, t_libc);
+		total_mismatches += mismatches;
+	}
+
+	return total_mismatches ? 1 : 0;
+}
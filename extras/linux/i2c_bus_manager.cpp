@@ -0,0 +1,328 @@
+/**
+ * i2c_bus_manager.cpp
+ *
+ * Created: 18/10/2026
+ * Author: SCHAAF Hugo
+ * Rev : 0
+ *
+ * Linux I2C bus manager shared by several drivers and threads.
+ */
+
+#include "i2c_bus_manager.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+namespace RTC {
+
+	/**
+	 * @brief      Convert an ioctl errno into a twi error.
+	 */
+	static int twiError(int e)
+	{
+		switch(e)
+		{
+			case ENXIO:
+			case EREMOTEIO:
+				return TWI_ERR_NACK_ADDR;
+			case ETIMEDOUT:
+				return TWI_ERR_TIMEOUT;
+			case EMSGSIZE:
+				return TWI_ERR_TOO_LONG;
+			default: // EAGAIN (arbitration lost), EIO, ...
+				return TWI_ERR_BUS;
+		}
+	}
+
+	I2CBusManager::I2CBusManager(): _fd{-1}, _plain_i2c{false}, _running{false}, _seq{0}, _stats{0, 0, 0, 0}
+	{
+		memset(_prio, PRIO_NORMAL, sizeof(_prio));
+		memset(_idempotent, 0, sizeof(_idempotent));
+	}
+
+	I2CBusManager::~I2CBusManager()
+	{
+		close();
+	}
+
+	/**
+	 * @brief      Open the adapter and start the bus thread.
+	 *
+	 * @param[in]  path  The adapter's device, e.g. "/dev/i2c-1"
+	 *
+	 * @return     0 on success or -errno.
+	 */
+	int I2CBusManager::open(const char* path)
+	{
+		unsigned long funcs = 0;
+
+		close();
+
+		_fd = ::open(path, O_RDWR);
+		if(_fd < 0) return -errno;
+
+		if(ioctl(_fd, I2C_FUNCS, &funcs) < 0)
+		{
+			int err = -errno;
+			::close(_fd);
+			_fd = -1;
+			return err;
+		}
+		_plain_i2c = funcs & I2C_FUNC_I2C;
+
+		_running = true;
+		_thread = std::thread(&I2CBusManager::run, this);
+		return 0;
+	}
+
+	/**
+	 * @brief      Stop the bus thread and close the adapter.
+	 */
+	void I2CBusManager::close()
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_running = false;
+		}
+		_submitted.notify_all();
+		if(_thread.joinable()) _thread.join();
+
+		// fail the transactions left in the queue
+		std::lock_guard<std::mutex> lock(_mutex);
+		while(!_queue.empty())
+		{
+			Transaction* t = _queue.top();
+			_queue.pop();
+			t->err = TWI_ERR_BUS;
+			t->done = true;
+		}
+		_completed.notify_all();
+
+		if(_fd >= 0) ::close(_fd);
+		_fd = -1;
+	}
+
+	void I2CBusManager::setPriority(uint8_t addr, i2c_prio_t prio)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_prio[addr & 0x7F] = prio;
+	}
+
+	void I2CBusManager::setIdempotentReads(uint8_t addr, bool enable)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_idempotent[addr & 0x7F] = enable;
+	}
+
+	int I2CBusManager::read(uint8_t addr, uint8_t start_reg, uint8_t* buffer, uint8_t length)
+	{
+		Transaction t;
+		t.addr = addr;
+		t.reg = start_reg;
+		t.read = true;
+		t.rbuf = buffer;
+		t.wbuf[0] = start_reg;
+		t.length = length;
+		return submit(t);
+	}
+
+	int I2CBusManager::write(uint8_t addr, uint8_t start_reg, const uint8_t* data, uint8_t length)
+	{
+		Transaction t;
+		if(length > I2C_BUS_MAX_WRITE) return TWI_ERR_TOO_LONG;
+		t.addr = addr;
+		t.reg = start_reg;
+		t.read = false;
+		t.rbuf = nullptr;
+		t.wbuf[0] = start_reg;
+		memcpy(&t.wbuf[1], data, length);
+		t.length = length;
+		return submit(t);
+	}
+
+	i2c_bus_stats_t I2CBusManager::stats()
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _stats;
+	}
+
+	/**
+	 * @brief      Queue a transaction and wait for its completion.
+	 *
+	 * @return     0 on success or the I2C bus error (see twi_err_t).
+	 */
+	int I2CBusManager::submit(Transaction &t)
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		if(!_running) return TWI_ERR_BUS;
+
+		t.prio = _prio[t.addr & 0x7F];
+		t.idempotent = t.read && _idempotent[t.addr & 0x7F];
+		t.seq = _seq++;
+		t.err = TWI_OK;
+		t.done = false;
+		_queue.push(&t);
+		_submitted.notify_one();
+
+		_completed.wait(lock, [&t]{ return t.done; });
+		return t.err;
+	}
+
+	/**
+	 * @brief      Bus thread. Every transaction queued while the previous batch
+	 *             was on the bus goes into the next batch, highest priority first.
+	 */
+	void I2CBusManager::run()
+	{
+		std::vector<Transaction*> batch;
+		std::unique_lock<std::mutex> lock(_mutex);
+
+		while(true)
+		{
+			_submitted.wait(lock, [this]{ return !_running || !_queue.empty(); });
+			if(!_running) break;
+
+			// pack as many transactions as fit in one I2C_RDWR ioctl
+			size_t msgs = 0;
+			batch.clear();
+			while(!_queue.empty())
+			{
+				size_t n = _queue.top()->read ? 2 : 1;
+				if(msgs + n > I2C_RDWR_IOCTL_MAX_MSGS) break;
+				msgs += n;
+				batch.push_back(_queue.top());
+				_queue.pop();
+				if(!_plain_i2c) break; // no batching without I2C_RDWR
+			}
+
+			lock.unlock();
+			execute(batch);
+			lock.lock();
+
+			for(Transaction* t : batch) t->done = true;
+			_stats.transactions += batch.size();
+			_completed.notify_all();
+		}
+	}
+
+	/**
+	 * @brief      Issue a batch of transactions on the bus.
+	 */
+	void I2CBusManager::execute(std::vector<Transaction*> &batch)
+	{
+		uint64_t ioctls = 0, batches = 0, splits = 0;
+
+		if(!_plain_i2c)
+		{
+			for(Transaction* t : batch)
+			{
+				t->err = executeSmbus(*t);
+				ioctls++;
+			}
+		}
+		else
+		{
+			int err = executeRdwr(batch.data(), batch.size());
+			ioctls++;
+			if(batch.size() > 1) batches++;
+
+			if(err && batch.size() > 1)
+			{
+				// The failing message is unknown and the ones before it may have
+				// been completed : only the idempotent reads are issued again.
+				splits++;
+				for(Transaction* t : batch)
+				{
+					if(t->idempotent)
+					{
+						t->err = executeRdwr(&t, 1);
+						ioctls++;
+					}
+					else t->err = err;
+				}
+			}
+			else
+			{
+				for(Transaction* t : batch) t->err = err;
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stats.ioctls += ioctls;
+		_stats.batches += batches;
+		_stats.splits += splits;
+	}
+
+	/**
+	 * @brief      Issue transactions in a single I2C_RDWR ioctl : the messages are
+	 *             separated by repeated START conditions and the ioctl ends with a STOP.
+	 *
+	 * @return     0 on success or the I2C bus error (see twi_err_t).
+	 */
+	int I2CBusManager::executeRdwr(Transaction** t, size_t count)
+	{
+		struct i2c_msg msgs[I2C_RDWR_IOCTL_MAX_MSGS];
+		struct i2c_rdwr_ioctl_data data;
+		size_t n = 0;
+
+		for(size_t i=0; i < count; i++)
+		{
+			// register address, followed by the data to write if any
+			msgs[n].addr  = t[i]->addr;
+			msgs[n].flags = 0;
+			msgs[n].len   = t[i]->read ? 1 : 1 + t[i]->length;
+			msgs[n].buf   = t[i]->wbuf;
+			n++;
+
+			if(t[i]->read)
+			{
+				msgs[n].addr  = t[i]->addr;
+				msgs[n].flags = I2C_M_RD;
+				msgs[n].len   = t[i]->length;
+				msgs[n].buf   = t[i]->rbuf;
+				n++;
+			}
+		}
+
+		data.msgs  = msgs;
+		data.nmsgs = n;
+		if(ioctl(_fd, I2C_RDWR, &data) < 0) return twiError(errno);
+		return TWI_OK;
+	}
+
+	/**
+	 * @brief      Issue a transaction with SMBus I2C block transfers.
+	 *
+	 * @return     0 on success or the I2C bus error (see twi_err_t).
+	 */
+	int I2CBusManager::executeSmbus(Transaction &t)
+	{
+		union i2c_smbus_data block;
+		struct i2c_smbus_ioctl_data args;
+
+		if(t.length > I2C_SMBUS_BLOCK_MAX) return TWI_ERR_TOO_LONG;
+		if(ioctl(_fd, I2C_SLAVE, (unsigned long)t.addr) < 0) return twiError(errno);
+
+		block.block[0] = t.length;
+		if(!t.read) memcpy(&block.block[1], &t.wbuf[1], t.length);
+
+		args.read_write = t.read ? I2C_SMBUS_READ : I2C_SMBUS_WRITE;
+		args.command    = t.reg;
+		args.size       = I2C_SMBUS_I2C_BLOCK_DATA;
+		args.data       = &block;
+		if(ioctl(_fd, I2C_SMBUS, &args) < 0) return twiError(errno);
+
+		if(t.read)
+		{
+			if(block.block[0] < t.length) return TWI_ERR_SHORT_READ;
+			memcpy(t.rbuf, &block.block[1], t.length);
+		}
+		return TWI_OK;
+	}
+
+} // namespace RTC
@@ -0,0 +1,185 @@
+/**
+ * i2c_bus_manager.hpp
+ *
+ * Created: 18/10/2026
+ * Author: SCHAAF Hugo
+ * Rev : 0
+ *
+ * Linux I2C bus manager shared by several drivers and threads. Transactions
+ * submitted by the drivers are queued, ordered by priority and packed into
+ * a single I2C_RDWR ioctl carrying up to I2C_RDWR_IOCTL_MAX_MSGS messages.
+ * The drivers plug into the bus manager through the twi wrapper of
+ * twi_wrapper_linux.hpp.
+ *
+ * Adapters which do not support plain I2C transfers (e.g. i2c-stub) are
+ * driven with SMBus I2C block transfers, one ioctl per transaction.
+ *
+ * When a batch fails, the kernel does not tell which message failed : the
+ * transactions before it may have been completed already. Transactions are
+ * therefore never replayed blindly. Only the reads of the slaves declared
+ * with setIdempotentReads() are issued again, one at a time, to get their
+ * own result. Every other transaction of the batch fails with the batch
+ * error and is left to the retry policy of the caller (see twi_transport.hpp).
+ */
+
+#ifndef I2C_BUS_MANAGER_HPP
+#define I2C_BUS_MANAGER_HPP 1
+
+#include <cstdint>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "twi_error.hpp"
+
+#define I2C_BUS_MAX_WRITE   32  /*< Maximum payload of a write transaction in bytes */
+
+namespace RTC
+{
+    /**
+     * Transaction priorities. Lower values are served first.
+     */
+    typedef enum
+    {
+        PRIO_REALTIME,  /*< time critical reads, e.g. the RTC tick read */
+        PRIO_NORMAL,
+        PRIO_BULK       /*< bulk sensor traffic */
+    } i2c_prio_t;
+
+    /**
+     * @brief       Bus manager counters.
+     */
+    typedef struct
+    {
+        uint64_t transactions;  /*< number of transactions completed */
+        uint64_t ioctls;        /*< number of ioctls issued */
+        uint64_t batches;       /*< number of I2C_RDWR ioctls carrying more than one transaction */
+        uint64_t splits;        /*< number of failed batches whose idempotent reads were replayed one at a time */
+    } i2c_bus_stats_t;
+
+
+    /**
+     * @brief      This class describes a Linux I2C adapter shared by several drivers.
+     */
+    class I2CBusManager
+    {
+
+    public:
+
+        I2CBusManager();
+        ~I2CBusManager();
+
+        I2CBusManager(const I2CBusManager&) = delete;
+        I2CBusManager& operator=(const I2CBusManager&) = delete;
+
+        /**
+         * @brief      Open the adapter and start the bus thread.
+         *
+         * @param[in]  path  The adapter's device, e.g. "/dev/i2c-1"
+         *
+         * @return     0 on success or -errno.
+         */
+        int open(const char* path);
+
+        /**
+         * @brief      Stop the bus thread and close the adapter. Pending
+         *             transactions fail with TWI_ERR_BUS.
+         */
+        void close();
+
+        /**
+         * @brief      Set the default priority of the transactions issued to a slave.
+         *             All the slaves have the PRIO_NORMAL priority by default.
+         *
+         * @param[in]  addr  The slave's address
+         * @param[in]  prio  The priority
+         */
+        void setPriority(uint8_t addr, i2c_prio_t prio);
+
+        /**
+         * @brief      Declare that reading the registers of a slave has no side
+         *             effect (no clear-on-read flag, no FIFO), so that its reads
+         *             can be issued again when their batch fails. Disabled by
+         *             default for all the slaves.
+         *
+         * @param[in]  addr    The slave's address
+         * @param[in]  enable  true if the reads are idempotent
+         */
+        void setIdempotentReads(uint8_t addr, bool enable);
+
+        /**
+         * @brief      Read length bytes starting at start_reg. Blocks until the
+         *             transaction has been issued on the bus.
+         *
+         * @return     0 on success or the I2C bus error (see twi_err_t).
+         */
+        int read(uint8_t addr, uint8_t start_reg, uint8_t* buffer, uint8_t length);
+
+        /**
+         * @brief      Write length bytes starting at start_reg. Blocks until the
+         *             transaction has been issued on the bus.
+         *
+         * @return     0 on success or the I2C bus error (see twi_err_t).
+         */
+        int write(uint8_t addr, uint8_t start_reg, const uint8_t* data, uint8_t length);
+
+        /**
+         * @brief      Retrieve the bus manager counters.
+         */
+        i2c_bus_stats_t stats();
+
+        /**
+         * @brief      Whether the adapter supports I2C_RDWR batching.
+         */
+        bool batching() const { return _plain_i2c; }
+
+    private:
+
+        struct Transaction
+        {
+            uint8_t addr;
+            uint8_t reg;
+            bool read;
+            uint8_t* rbuf;                          /*< read destination */
+            uint8_t wbuf[1 + I2C_BUS_MAX_WRITE];    /*< register address followed by the data to write */
+            uint8_t length;
+            uint8_t prio;
+            bool idempotent;                        /*< can be issued again if its batch fails */
+            uint64_t seq;                           /*< submission order, keeps FIFO order within a priority */
+            int err;
+            bool done;
+        };
+
+        struct Later
+        {
+            bool operator()(const Transaction* a, const Transaction* b) const
+            {
+                return (a->prio != b->prio) ? (a->prio > b->prio) : (a->seq > b->seq);
+            }
+        };
+
+        int submit(Transaction &t);
+        void run();
+        void execute(std::vector<Transaction*> &batch);
+        int executeRdwr(Transaction** t, size_t count);
+        int executeSmbus(Transaction &t);
+
+        int _fd;
+        bool _plain_i2c;
+        bool _running;
+        uint64_t _seq;
+        uint8_t _prio[128];
+        bool _idempotent[128];
+        i2c_bus_stats_t _stats;
+        std::priority_queue<Transaction*, std::vector<Transaction*>, Later> _queue;
+        std::mutex _mutex;
+        std::condition_variable _submitted;
+        std::condition_variable _completed;
+        std::thread _thread;
+    };
+
+} // namespace RTC
+
+#endif // I2C_BUS_MANAGER_HPP
@@ -0,0 +1,222 @@
+/**
+ * pcf2129_fleet.cpp
+ *
+ * Created: 18/10/2026
+ * Author: SCHAAF Hugo
+ * Rev : 0
+ *
+ * Provisioning of many PCF2129 at once, one per Linux I2C adapter.
+ */
+
+#include "pcf2129_fleet.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <thread>
+#include <dirent.h>
+
+#include "i2c_bus_manager.hpp"
+#include "twi_wrapper_linux.hpp"
+
+namespace RTC {
+
+	/**
+	 * @brief      Number of seconds between two dates.
+	 */
+	static int32_t difference(const DateTime &a, const DateTime &b)
+	{
+		return (int32_t)(to_epoch(a) - to_epoch(b));
+	}
+
+	/**
+	 * @brief      The host's UTC date and time.
+	 */
+	static DateTime hostDateTime()
+	{
+		DateTime dt;
+		struct tm tm;
+		time_t now = time(nullptr);
+		gmtime_r(&now, &tm);
+		dt.sec  = tm.tm_sec;
+		dt.min  = tm.tm_min;
+		dt.hour = tm.tm_hour;
+		dt.day  = tm.tm_mday;
+		dt.wday = tm.tm_wday;
+		dt.mon  = tm.tm_mon + 1;
+		dt.year = tm.tm_year % 100;
+		return dt;
+	}
+
+	/**
+	 * @brief      Check that both nibbles of a BCD register are decimal digits.
+	 */
+	static bool bcdValid(uint8_t bcd)
+	{
+		return (bcd & 0x0F) <= 9 && (bcd >> 4) <= 9;
+	}
+
+	/**
+	 * @brief      Probe the PCF2129 on an opened bus. The control and time
+	 *             registers are read in one transfer : the unused bits of
+	 *             CONTROL_1 and CONTROL_2 must be cleared and the time registers
+	 *             must hold valid BCD digits, so that another device answering
+	 *             at the same address (e.g. an EEPROM) is not mistaken for a
+	 *             PCF2129 and then written. Only the encoding is checked, not
+	 *             the ranges : an unset clock (e.g. all zeros on i2c-stub) is
+	 *             still a PCF2129 to provision.
+	 *
+	 * @return     0 if a PCF2129 answered, the I2C bus error or -1 otherwise.
+	 */
+	static int probe(I2CBusManager &bus, uint8_t addr)
+	{
+		uint8_t regs[YEARS - CONTROL_1 + 1] = {0}; // CONTROL_1 to YEARS
+		int err = bus.read(addr, CONTROL_1, regs, sizeof(regs));
+		if(err) return err;
+
+		const uint8_t* ctl = &regs[CONTROL_1];
+		const uint8_t* clk = &regs[SECONDS];
+		bool mode12h = ctl[0] & BIT_U8(CONTROL_1_12_24);
+
+		if((ctl[0] & ~CONTROL_1_FORMAT(0xFF)) || (ctl[1] & ~CONTROL_2_FORMAT(0xFF))) return -1;
+		if(!bcdValid(SECONDS_FORMAT(clk[0])) || !bcdValid(MINUTES_FORMAT(clk[1]))) return -1;
+		if(!bcdValid(mode12h ? (clk[2] & 0x1F) : HOURS_FORMAT(clk[2]))) return -1; // AMPM bit in 12h mode
+		if(!bcdValid(DAYS_FORMAT(clk[3])) || !bcdValid(MONTHS_FORMAT(clk[5])) || !bcdValid(YEARS_FORMAT(clk[6]))) return -1;
+		return 0;
+	}
+
+	/**
+	 * @brief      Open an adapter and probe the PCF2129.
+	 *
+	 * @return     0 on success, -errno, the I2C bus error or -1 otherwise.
+	 */
+	static int openAndProbe(I2CBusManager &bus, const std::string &adapter, uint8_t addr)
+	{
+		int err = bus.open(adapter.c_str());
+		if(err) return err;
+		bus.setIdempotentReads(addr, true); // reading the PCF2129 registers clears no flag
+		return probe(bus, addr);
+	}
+
+	std::vector<std::string> discoverPCF2129()
+	{
+		std::vector<std::string> candidates, found;
+		DIR* dir = opendir("/dev");
+		if(!dir) return found;
+
+		struct dirent* entry;
+		while((entry = readdir(dir)) != nullptr)
+		{
+			if(!strncmp(entry->d_name, "i2c-", 4)) candidates.push_back(std::string("/dev/") + entry->d_name);
+		}
+		closedir(dir);
+
+		std::vector<char> present(candidates.size(), 0);
+		std::vector<std::thread> workers;
+		for(size_t i=0; i < candidates.size(); i++)
+		{
+			workers.emplace_back([&candidates, &present, i]{
+				I2CBusManager bus;
+				PCF2129 rtc;
+				present[i] = (openAndProbe(bus, candidates[i], rtc.TWI_ADDR) == 0);
+			});
+		}
+		for(std::thread &w : workers) w.join();
+
+		for(size_t i=0; i < candidates.size(); i++)
+		{
+			if(present[i]) found.push_back(candidates[i]);
+		}
+		std::sort(found.begin(), found.end());
+		return found;
+	}
+
+	/**
+	 * @brief      Provision the PCF2129 of one adapter. Runs in its own worker thread.
+	 */
+	static void provision(provision_result_t &res, const std::function<void(PCF2129&)> &setup, uint8_t tolerance)
+	{
+		I2CBusManager bus;
+		PCF2129 rtc;
+		DateTime set, read;
+		bool osf = false;
+		int err = 0;
+		uint32_t t0 = twiWrapperMicros(), t = t0;
+
+		res.failed = STEP_OPEN;
+		res.osf = false;
+		res.drift_s = 0;
+		std::fill(res.step_us, res.step_us + STEP_DONE, 0);
+
+		// each step stores its duration and returns on error
+		#define STEP(step, call)								\
+			do {												\
+				res.failed = step;								\
+				err = (call);									\
+				res.step_us[step] = twiWrapperMicros() - t;		\
+				t = twiWrapperMicros();							\
+				if(err) goto end;								\
+			} while(0)
+
+		STEP(STEP_OPEN, openAndProbe(bus, res.adapter, rtc.TWI_ADDR));
+		twiLinuxSelectBus(&bus);
+
+		STEP(STEP_OSF, rtc.oscillatorStopped(osf));
+		res.osf = osf;
+
+		if(setup) setup(rtc);
+		STEP(STEP_CONFIGURE, rtc.configure());
+
+		set = hostDateTime();
+		STEP(STEP_SET, rtc.setDateTime(set));
+
+		set = hostDateTime(); // the time may have ticked since it was set
+		STEP(STEP_VERIFY, rtc.dateTime(read));
+		res.drift_s = difference(read, set);
+		if(res.drift_s < -tolerance || res.drift_s > tolerance)
+		{
+			err = -1;
+			goto end;
+		}
+
+		STEP(STEP_OSF_CLEARED, rtc.oscillatorStopped(osf));
+		if(osf)
+		{
+			err = -1;
+			goto end;
+		}
+
+		res.failed = STEP_DONE;
+
+		#undef STEP
+
+	end:
+		res.err = err;
+		res.total_us = twiWrapperMicros() - t0;
+		twiLinuxSelectBus(nullptr);
+	}
+
+	std::vector<provision_result_t> provisionPCF2129(const std::vector<std::string> &adapters,
+	                                                 const std::function<void(PCF2129&)> &setup,
+	                                                 uint8_t tolerance)
+	{
+		std::vector<provision_result_t> results(adapters.size());
+		std::vector<std::thread> workers;
+
+		for(size_t i=0; i < adapters.size(); i++)
+		{
+			results[i].adapter = adapters[i];
+			workers.emplace_back(provision, std::ref(results[i]), std::cref(setup), tolerance);
+		}
+		for(std::thread &w : workers) w.join();
+
+		return results;
+	}
+
+	const char* provisionStepName(provision_step_t step)
+	{
+		static const char* const names[] = {"open", "osf", "configure", "set", "verify", "osf-cleared", "done"};
+		return (step <= STEP_DONE) ? names[step] : "?";
+	}
+
+} // namespace RTC
@@ -0,0 +1,86 @@
+/**
+ * pcf2129_fleet.hpp
+ *
+ * Created: 18/10/2026
+ * Author: SCHAAF Hugo
+ * Rev : 0
+ *
+ * Provisioning of many PCF2129 at once, one per Linux I2C adapter
+ * (e.g. a factory test rig with many USB-I2C adapters). The devices are
+ * provisioned concurrently with one worker thread per adapter.
+ *
+ * Requires the Linux twi wrapper (see twi_wrapper_linux.hpp).
+ */
+
+#ifndef PCF2129_FLEET_HPP
+#define PCF2129_FLEET_HPP 1
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "pcf2129.hpp"
+
+namespace RTC
+{
+    /**
+     * Provisioning steps, in execution order.
+     */
+    typedef enum
+    {
+        STEP_OPEN,          /*< open the adapter and probe the device */
+        STEP_OSF,           /*< read the oscillator stop flag left by the previous run */
+        STEP_CONFIGURE,     /*< configure() */
+        STEP_SET,           /*< setDateTime() with the host's UTC time */
+        STEP_VERIFY,        /*< dateTime() readback compared with the host's UTC time */
+        STEP_OSF_CLEARED,   /*< check that setDateTime() cleared OSF */
+        STEP_DONE
+    } provision_step_t;
+
+    /**
+     * @brief       Outcome of the provisioning of one device.
+     */
+    typedef struct
+    {
+        std::string adapter;        /*< adapter's device, e.g. "/dev/i2c-3" */
+        provision_step_t failed;    /*< step which failed, STEP_DONE on success */
+        int err;                    /*< error of the failed step : twi_err_t, -errno for STEP_OPEN, -1 for a check */
+        bool osf;                   /*< the oscillator had stopped before provisioning */
+        int32_t drift_s;            /*< readback minus host time in seconds */
+        uint32_t step_us[STEP_DONE];/*< duration of each step in us */
+        uint32_t total_us;          /*< duration of the whole provisioning in us */
+    } provision_result_t;
+
+    /**
+     * @brief      List the adapters with a PCF2129 answering at its address.
+     *             All the /dev/i2c-* adapters are probed concurrently.
+     *
+     * @return     The adapters' devices, sorted.
+     */
+    std::vector<std::string> discoverPCF2129();
+
+    /**
+     * @brief      Provision the PCF2129 of every adapter concurrently, one worker
+     *             thread per adapter : configure, set the date and time from the
+     *             host's UTC clock, read it back and check the oscillator stop flag.
+     *
+     * @param[in]  adapters   The adapters' devices
+     * @param[in]  setup      Called on each driver before configure() to select
+     *                        the configuration, may be empty
+     * @param[in]  tolerance  Maximum readback drift accepted in seconds
+     *
+     * @return     One result per adapter, in the same order.
+     */
+    std::vector<provision_result_t> provisionPCF2129(const std::vector<std::string> &adapters,
+                                                     const std::function<void(PCF2129&)> &setup = nullptr,
+                                                     uint8_t tolerance = 1);
+
+    /**
+     * @brief      Name of a provisioning step.
+     */
+    const char* provisionStepName(provision_step_t step);
+
+} // namespace RTC
+
+#endif // PCF2129_FLEET_HPP
@@ -0,0 +1,83 @@
+/**
+ * pcf2129_provision.cpp
+ *
+ * Created: 18/10/2026
+ * Author: SCHAAF Hugo
+ * Rev : 0
+ *
+ * Host tool provisioning the PCF2129 of many I2C adapters concurrently
+ * (see pcf2129_fleet.hpp) and printing a per-device timing report.
+ *
+ * Build (from this directory) :
+ *
+ *	g++ -std=c++11 -O2 -pthread -I. -I../.. -DTWI_WRAPPER_HEADER='"twi_wrapper_linux.hpp"' \
+ *		pcf2129_provision.cpp pcf2129_fleet.cpp i2c_bus_manager.cpp ../../pcf2129.cpp \
+ *		-o pcf2129_provision
+ *
+ * Usage :
+ *
+ *	pcf2129_provision adapter...
+ *	pcf2129_provision --all
+ *	pcf2129_provision
+ *
+ * The given adapters are provisioned. With --all, every /dev/i2c-* adapter
+ * with a PCF2129 is provisioned. Without any argument, the adapters with a
+ * PCF2129 are only listed and nothing is written. Without hardware, the
+ * single adapter created by i2c-stub (see twi_wrapper_linux.hpp) is seen
+ * as one device.
+ *
+ * The exit status is 0 if every device has been provisioned, 1 otherwise.
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include "pcf2129_fleet.hpp"
+
+using namespace RTC;
+
+int main(int argc, char** argv)
+{
+	std::vector<std::string> adapters(argv + 1, argv + argc);
+	uint32_t t0 = twiWrapperMicros();
+	uint64_t sequential = 0;
+	size_t failed = 0;
+
+	bool all = (adapters.size() == 1 && !strcmp(adapters[0].c_str(), "--all"));
+
+	if(adapters.empty() || all) adapters = discoverPCF2129();
+	if(adapters.empty())
+	{
+		fprintf(stderr, "no PCF2129 found\n");
+		return 1;
+	}
+	if(argc == 1)
+	{
+		// writing requires the adapters to be named explicitly or --all
+		for(const std::string &adapter : adapters) printf("%s\n", adapter.c_str());
+		return 0;
+	}
+
+	std::vector<provision_result_t> results = provisionPCF2129(adapters);
+	uint32_t wall = twiWrapperMicros() - t0;
+
+	printf("%-16s %-12s %-4s %-3s %5s", "adapter", "status", "err", "osf", "drift");
+	for(uint8_t s=0; s < STEP_DONE; s++) printf(" %11s", provisionStepName((provision_step_t)s));
+	printf(" %11s\n", "total (us)");
+
+	for(const provision_result_t &res : results)
+	{
+		printf("%-16s %-12s %-4d %-3s %5d", res.adapter.c_str(),
+		       res.failed == STEP_DONE ? "ok" : provisionStepName(res.failed),
+		       res.err, res.osf ? "yes" : "no", res.drift_s);
+		for(uint8_t s=0; s < STEP_DONE; s++) printf(" %11u", res.step_us[s]);
+		printf(" %11u\n", res.total_us);
+
+		sequential += res.total_us;
+		if(res.failed != STEP_DONE) failed++;
+	}
+
+	printf("%zu devices, %zu failed, wall time %u us, sum of device times %llu us\n",
+	       results.size(), failed, wall, (unsigned long long)sequential);
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,134 @@
+/**
+ * twi_wrapper_linux.hpp
+ *
+ * Created: 18/10/2026
+ * Author: SCHAAF Hugo
+ * Rev : 0
+ *
+ * Linux implementation of the twi wrapper's functions (see twi_wrapper.hpp).
+ * Every transaction goes through an I2CBusManager, so that several drivers
+ * and threads share one adapter. Select it with :
+ *
+ *	-DTWI_WRAPPER_HEADER='"twi_wrapper_linux.hpp"'
+ *
+ * Each thread selects the bus its drivers talk to with twiLinuxSelectBus()
+ * before using them. Example with the RTC tick read served before the
+ * sensors traffic :
+ *
+ *	RTC::I2CBusManager bus;
+ *	bus.open("/dev/i2c-1");
+ *	bus.setPriority(0x51, RTC::PRIO_REALTIME);
+ *	bus.setIdempotentReads(0x51, true);
+ *	twiLinuxSelectBus(&bus);
+ *
+ *	RTC::PCF2129 rtc;
+ *	rtc.dateTime(dt);
+ *
+ * Build :
+ *
+ *	g++ -std=c++11 -pthread -I<repo> -I<repo>/extras/linux \
+ *		-DTWI_WRAPPER_HEADER='"twi_wrapper_linux.hpp"' \
+ *		app.cpp <repo>/pcf2129.cpp <repo>/extras/linux/i2c_bus_manager.cpp
+ *
+ * To test without hardware, load i2c-stub with a chip at the RTC address :
+ *
+ *	modprobe i2c-stub chip_addr=0x51
+ *
+ * i2c-stub creates a single adapter, whatever the number of chips given in
+ * chip_addr, so only one PCF2129 can be simulated at a time. Its registers
+ * start cleared, which the PCF2129 probe accepts.
+ *
+ * i2c-stub only supports SMBus transfers so the transactions are not
+ * batched on it (see I2CBusManager::batching()).
+ */
+
+#ifndef TWI_WRAPPER_LINUX_HPP
+#define TWI_WRAPPER_LINUX_HPP 1
+
+#include <cstdint>
+#include <ctime>
+
+#include "twi_error.hpp"
+#include "i2c_bus_manager.hpp"
+
+/**
+ * @brief      The bus used by the drivers of the calling thread.
+ */
+inline
+RTC::I2CBusManager*& twiLinuxBus()
+{
+    static thread_local RTC::I2CBusManager* bus = nullptr;
+    return bus;
+}
+
+/**
+ * @brief      Select the bus used by the drivers of the calling thread.
+ *
+ * @param      bus   The bus manager, opened
+ */
+static inline
+void twiLinuxSelectBus(RTC::I2CBusManager* bus)
+{
+    twiLinuxBus() = bus;
+}
+
+
+/**
+ * @brief      Initialize the I2C peripheral. The bus manager must have been
+ *             opened and selected with twiLinuxSelectBus().
+ *
+ * @return     0 on success or TWI_ERR_BUS if no bus is selected.
+ */
+static inline
+int twiWrapperPeripheralInit()
+{
+    return twiLinuxBus() ? TWI_OK : TWI_ERR_BUS;
+}
+
+/**
+ * @brief      Free running microseconds counter.
+ */
+static inline
+uint32_t twiWrapperMicros()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+}
+
+static inline
+int twiWrapperReadMultipleRegisters(uint8_t addr, uint8_t start_reg, uint8_t* buffer, uint8_t length)
+{
+    RTC::I2CBusManager* bus = twiLinuxBus();
+    return bus ? bus->read(addr, start_reg, buffer, length) : TWI_ERR_BUS;
+}
+
+static inline
+int twiWrapperReadRegister(uint8_t addr, uint8_t reg, uint8_t* val)
+{
+    return twiWrapperReadMultipleRegisters(addr, reg, val, 1);
+}
+
+static inline
+int twiWrapperWriteMultpileRegisters(uint8_t addr, uint8_t start_reg, const uint8_t* data, uint8_t length)
+{
+    RTC::I2CBusManager* bus = twiLinuxBus();
+    return bus ? bus->write(addr, start_reg, data, length) : TWI_ERR_BUS;
+}
+
+static inline
+int twiWrapperWriteRegister(uint8_t addr, uint8_t reg, uint8_t val)
+{
+    return twiWrapperWriteMultpileRegisters(addr, reg, &val, 1);
+}
+
+/**
+ * @brief      Bus recovery is performed by the adapter's kernel driver.
+ */
+static inline
+int twiWrapperBusRecover()
+{
+    return TWI_OK;
+}
+
+#endif // TWI_WRAPPER_LINUX_HPP
@@ -0,0 +1,170 @@
+/**
+ * pcf2129_replay.cpp
+ *
+ * Created: 18/10/2026
+ * Author: SCHAAF Hugo
+ * Rev : 0
+ *
+ * Host tool feeding a trace recorded with twi_trace.hpp back to the
+ * PCF2129 driver. Date and time burst transfers are replayed through
+ * PCF2129::dateTime() and PCF2129::setDateTime(), any other transaction
+ * is replayed as is through the transport. For each transaction the
+ * recorded and the replayed durations are printed.
+ *
+ * Build (from this directory) :
+ *
+ *	g++ -std=c++11 -O2 -I. -I../.. -DTWI_WRAPPER_HEADER='"twi_replay.hpp"' \
+ *		pcf2129_replay.cpp twi_replay.cpp ../../pcf2129.cpp ../../twi_trace.cpp \
+ *		-o pcf2129_replay
+ *
+ * Usage :
+ *
+ *	pcf2129_replay [-r] [-12] trace.bin
+ *
+ *	-r	realtime : each transaction lasts at least its recorded duration
+ *	-12	the trace was recorded in 12h mode. The count mode is also
+ *		followed from the CONTROL_1 writes of the trace
+ *
+ * The trace file is a twi_trace_header_t followed by the records.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "pcf2129.hpp"
+#include "twi_replay.hpp"
+
+using namespace RTC;
+
+static void onMismatch(uint16_t index, const char* what)
+{
+	printf("  ! record %u : %s mismatch\n", index, what);
+}
+
+/**
+ * @brief      Load a trace dump.
+ *
+ * @return     0 on success, -1 otherwise.
+ */
+static int loadTrace(const char* path, std::vector<twi_trace_record_t> &records)
+{
+	twi_trace_header_t header;
+	FILE* f = fopen(path, "rb");
+	if(!f)
+	{
+		perror(path);
+		return -1;
+	}
+
+	if(fread(&header, sizeof(header), 1, f) != 1
+	   || (header.magic[0] | header.magic[1]<<8 | header.magic[2]<<16 | (uint32_t)header.magic[3]<<24) != TWI_TRACE_MAGIC
+	   || header.version != TWI_TRACE_VERSION
+	   || header.record_size != sizeof(twi_trace_record_t))
+	{
+		fprintf(stderr, "%s : not a version %d trace\n", path, TWI_TRACE_VERSION);
+		fclose(f);
+		return -1;
+	}
+
+	records.resize(header.count_lo | header.count_hi<<8);
+	size_t n = fread(records.data(), sizeof(twi_trace_record_t), records.size(), f);
+	fclose(f);
+	if(n != records.size())
+	{
+		fprintf(stderr, "%s : truncated trace, %zu records out of %zu\n", path, n, records.size());
+		records.resize(n);
+	}
+	return 0;
+}
+
+/**
+ * @brief      Sum of the recorded durations of the records consumed since first.
+ */
+static uint32_t recordedDuration(const std::vector<twi_trace_record_t> &records, uint16_t first)
+{
+	uint32_t us = 0;
+	for(uint16_t i=first; i < twiReplayPosition(); i++) us += twiTraceDuration(records[i]);
+	return us;
+}
+
+int main(int argc, char** argv)
+{
+	bool realtime = false;
+	bool mode12h = false;
+	const char* path = nullptr;
+	std::vector<twi_trace_record_t> records;
+
+	for(int i=1; i < argc; i++)
+	{
+		if(!strcmp(argv[i], "-r"))       realtime = true;
+		else if(!strcmp(argv[i], "-12")) mode12h = true;
+		else                             path = argv[i];
+	}
+	if(!path)
+	{
+		fprintf(stderr, "usage : %s [-r] [-12] trace.bin\n", argv[0]);
+		return 2;
+	}
+	if(loadTrace(path, records)) return 2;
+
+	twiReplayLoad(records.data(), records.size(), realtime);
+	twiReplaySetMismatchHandler(onMismatch);
+
+	PCF2129 rtc;
+	const twi_trace_record_t* rec;
+
+	if(mode12h) rtc.selectCountMode(MODE12H);
+
+	printf("%-6s %-11s %-4s %-3s %-4s %9s %9s\n", "index", "op", "reg", "len", "err", "rec (us)", "play (us)");
+
+	while((rec = twiReplayPeek()) != nullptr)
+	{
+		uint16_t first = twiReplayPosition();
+		uint8_t len = twiTraceLength(*rec);
+		uint8_t buf[TWI_TRACE_PAYLOAD_MAX] = {0};
+		const char* op;
+		int err = 0;
+
+		uint32_t t0 = twiWrapperMicros();
+		if(rec->addr == rtc.TWI_ADDR && rec->reg == SECONDS && len == sizeof(DateTime))
+		{
+			DateTime dt;
+			if(twiTraceDir(*rec) == TWI_TRACE_READ)
+			{
+				op = "dateTime";
+				err = rtc.dateTime(dt);
+			}
+			else
+			{
+				op = "setDateTime";
+				TimeSnapshot snap;
+				memcpy(snap.raw, rec->payload, sizeof(snap.raw));
+				rtc.decode(snap, dt); // hours decoded in the count mode in use
+				err = rtc.setDateTime(dt);
+			}
+		}
+		else if(twiTraceDir(*rec) == TWI_TRACE_READ)
+		{
+			op = "read";
+			err = twiTransportReadMultipleRegisters(rec->addr, rec->reg, buf, len);
+		}
+		else
+		{
+			op = "write";
+			// follow the count mode selected by the recorded configuration
+			if(rec->addr == rtc.TWI_ADDR && rec->reg == CONTROL_1 && len)
+			{
+				rtc.selectCountMode((rec->payload[0] & BIT_U8(CONTROL_1_12_24)) ? MODE12H : MODE24H);
+			}
+			err = twiTransportWriteMultipleRegisters(rec->addr, rec->reg, rec->payload, len);
+		}
+		uint32_t played = twiWrapperMicros() - t0;
+
+		printf("%-6u %-11s 0x%02X %-3u %-4d %9u %9u\n", first, op, rec->reg, len, err,
+		       recordedDuration(records, first), played);
+	}
+
+	printf("%zu records replayed, %u mismatches\n", records.size(), twiReplayMismatches());
+	return twiReplayMismatches() ? 1 : 0;
+}
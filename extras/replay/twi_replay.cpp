@@ -0,0 +1,150 @@
+/**
+ * twi_replay.cpp
+ *
+ * Created: 18/10/2026
+ * Author: SCHAAF Hugo
+ * Rev : 0
+ *
+ * Fake I2C device replaying a trace recorded with twi_trace.hpp.
+ */
+
+#include "twi_replay.hpp"
+
+#include <chrono>
+
+static const twi_trace_record_t* _records = nullptr;
+static uint16_t _count = 0;
+static uint16_t _pos = 0;
+static bool _realtime = false;
+static uint32_t _mismatches = 0;
+static twi_replay_mismatch_handler_t _handler = nullptr;
+
+static void mismatch(uint16_t index, const char* what)
+{
+	_mismatches++;
+	if(_handler) _handler(index, what);
+}
+
+/**
+ * @brief      Consume the next record and check it against the issued transaction.
+ *
+ * @return     The record or nullptr if the trace is exhausted.
+ */
+static const twi_trace_record_t* next(uint8_t addr, uint8_t reg, uint8_t dir, uint8_t length)
+{
+	if(_pos >= _count)
+	{
+		mismatch(_pos, "trace exhausted");
+		return nullptr;
+	}
+
+	const twi_trace_record_t* rec = &_records[_pos];
+
+	if(rec->addr != addr)          mismatch(_pos, "address");
+	if(rec->reg != reg)            mismatch(_pos, "register");
+	if(twiTraceDir(*rec) != dir)   mismatch(_pos, "direction");
+	if(twiTraceLength(*rec) != length) mismatch(_pos, "length");
+
+	_pos++;
+	return rec;
+}
+
+/**
+ * @brief      Spend the recorded duration of the transaction if replaying in realtime.
+ */
+static void wait(const twi_trace_record_t* rec, uint32_t t0)
+{
+	if(!_realtime) return;
+	while(twiWrapperMicros() - t0 < twiTraceDuration(*rec));
+}
+
+
+void twiReplayLoad(const twi_trace_record_t* records, uint16_t count, bool realtime)
+{
+	_records = records;
+	_count = count;
+	_pos = 0;
+	_realtime = realtime;
+	_mismatches = 0;
+}
+
+void twiReplaySetMismatchHandler(twi_replay_mismatch_handler_t handler)
+{
+	_handler = handler;
+}
+
+const twi_trace_record_t* twiReplayPeek()
+{
+	return (_pos < _count) ? &_records[_pos] : nullptr;
+}
+
+uint16_t twiReplayPosition()
+{
+	return _pos;
+}
+
+uint32_t twiReplayMismatches()
+{
+	return _mismatches;
+}
+
+
+int twiWrapperPeripheralInit()
+{
+	return 0;
+}
+
+uint32_t twiWrapperMicros()
+{
+	using namespace std::chrono;
+	return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+int twiWrapperReadRegister(uint8_t addr, uint8_t reg, uint8_t* val)
+{
+	return twiWrapperReadMultipleRegisters(addr, reg, val, 1);
+}
+
+int twiWrapperReadMultipleRegisters(uint8_t addr, uint8_t start_reg, uint8_t* buffer, uint8_t length)
+{
+	uint32_t t0 = twiWrapperMicros();
+	const twi_trace_record_t* rec = next(addr, start_reg, TWI_TRACE_READ, length);
+	if(!rec) return TWI_ERR_NACK_ADDR;
+
+	for(uint8_t i=0; i < length; i++)
+	{
+		// bytes beyond the recorded payload were not stored
+		buffer[i] = (i < TWI_TRACE_PAYLOAD_MAX) ? rec->payload[i] : 0x00;
+	}
+	wait(rec, t0);
+	return rec->err;
+}
+
+int twiWrapperWriteRegister(uint8_t addr, uint8_t reg, uint8_t val)
+{
+	return twiWrapperWriteMultpileRegisters(addr, reg, &val, 1);
+}
+
+int twiWrapperWriteMultpileRegisters(uint8_t addr, uint8_t start_reg, const uint8_t* data, uint8_t length)
+{
+	uint32_t t0 = twiWrapperMicros();
+	uint16_t index = _pos;
+	const twi_trace_record_t* rec = next(addr, start_reg, TWI_TRACE_WRITE, length);
+	if(!rec) return TWI_ERR_NACK_ADDR;
+
+	for(uint8_t i=0; i < length && i < TWI_TRACE_PAYLOAD_MAX; i++)
+	{
+		if(rec->payload[i] != data[i])
+		{
+			mismatch(index, "written data");
+			break;
+		}
+	}
+	wait(rec, t0);
+	return rec->err;
+}
+
+int twiWrapperBusRecover()
+{
+	return TWI_OK;
+}
@@ -0,0 +1,81 @@
+/**
+ * twi_replay.hpp
+ *
+ * Created: 18/10/2026
+ * Author: SCHAAF Hugo
+ * Rev : 0
+ *
+ * Fake I2C device replaying a trace recorded with twi_trace.hpp.
+ * This file implements the twi wrapper's functions (see twi_wrapper.hpp)
+ * on a host so that the driver can be run against a recorded session :
+ *
+ *	-DTWI_WRAPPER_HEADER='"twi_replay.hpp"'
+ *
+ * Each transaction issued by the driver consumes the next record of the
+ * trace. Reads return the recorded payload and every transaction returns
+ * the recorded bus error. Any difference between the issued transaction and the
+ * record (address, register, direction, length or written bytes) is
+ * counted as a mismatch and reported to the mismatch handler.
+ */
+
+#ifndef TWI_REPLAY_HPP
+#define TWI_REPLAY_HPP 1
+
+#include <cstdint>
+
+#include "twi_error.hpp"
+#include "twi_trace.hpp"
+
+/**
+ * @brief      Mismatch handler.
+ *
+ * @param[in]  index  The index of the record in the trace
+ * @param[in]  what   A short description of the mismatch
+ */
+typedef void (*twi_replay_mismatch_handler_t)(uint16_t index, const char* what);
+
+/**
+ * @brief      Load a trace. The records are not copied and must stay valid
+ *             during the replay.
+ *
+ * @param[in]  records   The records, oldest first
+ * @param[in]  count     The number of records
+ * @param[in]  realtime  If true, each transaction lasts at least its recorded duration
+ */
+void twiReplayLoad(const twi_trace_record_t* records, uint16_t count, bool realtime);
+
+/**
+ * @brief      Set the mismatch handler. nullptr to disable.
+ */
+void twiReplaySetMismatchHandler(twi_replay_mismatch_handler_t handler);
+
+/**
+ * @brief      The next record to be replayed.
+ *
+ * @return     The next record or nullptr if the trace is exhausted.
+ */
+const twi_trace_record_t* twiReplayPeek();
+
+/**
+ * @brief      The index of the next record to be replayed.
+ */
+uint16_t twiReplayPosition();
+
+/**
+ * @brief      The number of mismatches since the trace has been loaded.
+ */
+uint32_t twiReplayMismatches();
+
+
+/**
+ * twi wrapper's functions. See twi_wrapper.hpp
+ */
+int      twiWrapperPeripheralInit();
+uint32_t twiWrapperMicros();
+int      twiWrapperReadRegister(uint8_t addr, uint8_t reg, uint8_t* val);
+int      twiWrapperReadMultipleRegisters(uint8_t addr, uint8_t start_reg, uint8_t* buffer, uint8_t length);
+int      twiWrapperWriteRegister(uint8_t addr, uint8_t reg, uint8_t val);
+int      twiWrapperWriteMultpileRegisters(uint8_t addr, uint8_t start_reg, const uint8_t* data, uint8_t length);
+int      twiWrapperBusRecover();
+
+#endif // TWI_REPLAY_HPP
@@ -12,6 +12,9 @@
 #include "pcf2129.hpp"
 #include "pcf2129_registers.h"
 
+#define METRICS_BEGIN()					uint32_t _metrics_t0 = metricsBegin()
+#define METRICS_END(op, err, bytes)		metricsEnd(op, _metrics_t0, err, bytes)
+
 namespace RTC {
 	/**
 	 * @brief      Write the configuration to the RTC. 
@@ -23,18 +26,26 @@ namespace RTC {
 	 */
 	int PCF2129::configure()
 	{
+		METRICS_BEGIN();
 		int err = -1;
-		err = twiWrapperWriteRegister(TWI_ADDR, 	CONTROL_1, 	CONTROL_1_FORMAT(_control1) );
-		if(err) return err;
-		err = twiWrapperWriteRegister(TWI_ADDR, 	CONTROL_2, 	CONTROL_2_FORMAT(_control2) );
-		if(err) return err;
-		err = twiWrapperWriteRegister(TWI_ADDR, 	CONTROL_3, 	CONTROL_3_FORMAT(_control3) );
-		if(err) return err;
-		err = twiWrapperWriteRegister(TWI_ADDR, 	CLKOUT_CTL, CLKOUT_CTL_FORMAT(_clkout_ctl) );
-		if(err) return err;
-		err = twiWrapperWriteRegister(TWI_ADDR, 	WATCHDG_TIM_CTL,	WATCHDG_TIM_CTL_FORMAT(_watchdg_tim_ctl) );
-		if(err) return err;
-		err = twiWrapperWriteRegister(TWI_ADDR, 	TIMESTP_CTL,		TIMESTP_CTL_FORMAT(_timestp_ctl) );
+		uint8_t bytes = 0; // Number of registers written
+		const uint8_t config[][2] = {
+			{CONTROL_1,			(uint8_t)CONTROL_1_FORMAT(_control1)},
+			{CONTROL_2,			(uint8_t)CONTROL_2_FORMAT(_control2)},
+			{CONTROL_3,			(uint8_t)CONTROL_3_FORMAT(_control3)},
+			{CLKOUT_CTL,		(uint8_t)CLKOUT_CTL_FORMAT(_clkout_ctl)},
+			{WATCHDG_TIM_CTL,	(uint8_t)WATCHDG_TIM_CTL_FORMAT(_watchdg_tim_ctl)},
+			{TIMESTP_CTL,		(uint8_t)TIMESTP_CTL_FORMAT(_timestp_ctl)},
+		};
+
+		for(uint8_t i=0; i < sizeof(config)/sizeof(config[0]); i++)
+		{
+			err = twiTransportWriteRegister(TWI_ADDR, config[i][0], config[i][1]);
+			if(err) break;
+			bytes++;
+		}
+
+		METRICS_END(OP_CONFIGURE, err, bytes);
 		return err;
 	}
 
@@ -45,9 +56,11 @@ namespace RTC {
 	 */
 	int PCF2129::start()
 	{
+		METRICS_BEGIN();
 		int err = -1;
 		_control1 &= ~BIT_U8(CONTROL_1_STOP); // clear the stop bit to start the RTC
-		err = twiWrapperWriteRegister(TWI_ADDR, CONTROL_1, CONTROL_1_FORMAT(_control1) );
+		err = twiTransportWriteRegister(TWI_ADDR, CONTROL_1, CONTROL_1_FORMAT(_control1) );
+		METRICS_END(OP_START, err, err ? 0 : 1);
 		return err;
 	}
 
@@ -58,29 +71,14 @@ namespace RTC {
 	 */
 	int PCF2129::stop()
 	{
+		METRICS_BEGIN();
 		int err = -1;
 		_control1 |= BIT_U8(CONTROL_1_STOP); // set the stop bit to stop the RTC
-		err = twiWrapperWriteRegister(TWI_ADDR, CONTROL_1, CONTROL_1_FORMAT(_control1) );
+		err = twiTransportWriteRegister(TWI_ADDR, CONTROL_1, CONTROL_1_FORMAT(_control1) );
+		METRICS_END(OP_STOP, err, err ? 0 : 1);
 		return err;
 	}
 
-    /**
-     * @brief      Select whether the clock operates in 12H or 24H mode.
-     *
-     * @param[in]  mode  the count mode
-     */
-    void PCF2129::selectCountMode(count_mode_t mode)
-	{
-		if(mode == MODE12H)
-		{
-			_control1 |= BIT_U8(CONTROL_1_12_24); // set 12_24 bit
-		}
-		else if( mode == MODE24H)
-		{
-			_control1 &= ~BIT_U8(CONTROL_1_12_24); // clear 12_24 bit
-		}
-	}
-
 	/**
 	 * @brief      Sets the CLKOUT frequency.
 	 *
@@ -119,67 +117,162 @@ namespace RTC {
 	}
 
 	/**
-	 * @brief      Sets the date and the time in the RTC
+	 * @brief      Select the power management mode (battery switch-over
+	 *             and battery low detection).
+	 *
+	 * @param[in]  mode  The power management mode
+	 */
+	void PCF2129::selectPowerManagementMode(pwrmng_mode_t mode)
+	{
+		_control3 &= ~CONTROL_3_PWRMNG_MASK; // reset PWRMNG[2:0] bits
+		_control3 |= (uint8_t)(mode << CONTROL_3_PWRMNG_0) & CONTROL_3_PWRMNG_MASK;
+	}
+
+	/**
+	 * @brief      Enable or disable the battery interrupts on pin /INT.
 	 *
-	 * @param      datetime  The datetime data to write to the RTC.
+	 *             BLF is only set when battery low detection is enabled : when
+	 *             battery_low is requested, the power management mode is
+	 *             switched to its battery low detection enabled counterpart
+	 *             (PWRMNG_STANDARD_BLD or PWRMNG_DIRECT_BLD). PWRMNG_VDD_ONLY
+	 *             has none and is left unchanged.
 	 *
-	 * @return     0 on success or the I2C bus error.
+	 * @param[in]  battery_low  Interrupt when the battery low flag (BLF) is set
+	 * @param[in]  switchover   Interrupt when the battery switch-over flag (BF) is set
 	 */
-	int PCF2129::setDateTime(DateTime &datetime)
+	void PCF2129::selectBatteryInterrupts(bool battery_low, bool switchover)
 	{
-		int err = -1;
-		uint8_t* tmp = (uint8_t*)(&datetime);
-		// convert each Datetime struct member into BCD format
-		for(uint8_t i=0; i < sizeof(datetime);)
+		_control3 &= ~(BIT_U8(CONTROL_3_BLIE) | BIT_U8(CONTROL_3_BIE)); // reset BLIE and BIE bits
+		if(battery_low)
 		{
-			tmp[i] = dec_to_bcd(tmp[i]);
-			i++;
+			uint8_t mode = (_control3 & CONTROL_3_PWRMNG_MASK) >> CONTROL_3_PWRMNG_0;
+			if(mode <= 0x02)      selectPowerManagementMode(PWRMNG_STANDARD_BLD);
+			else if(mode <= 0x05) selectPowerManagementMode(PWRMNG_DIRECT_BLD);
+			_control3 |= BIT_U8(CONTROL_3_BLIE);
 		}
-		err = twiWrapperWriteMultpileRegisters(TWI_ADDR, SECONDS, tmp, sizeof(datetime) );
-		return err;
+		if(switchover)  _control3 |= BIT_U8(CONTROL_3_BIE);
 	}
 
 	/**
-	 * @brief      Read the date ant time from RTC. The 7 different data registers
-	 *  			are read in a single I2C data transfer from the RTC.
-	 *  			
-	 * @param      datetime  The datetime structure to be filled
+	 * @brief      Enable or disable the time stamp on battery switch-over (BTSE).
 	 *
-	 * @return     0 if success, -1 if an error occured during the I2C transfer.
+	 * @param[in]  enable  The enable
 	 */
-	int PCF2129::dateTime(DateTime &datetime)
+	void PCF2129::selectBatterySwitchoverTimestamp(bool enable)
 	{
-		int err = -1; // error
-		uint8_t br = 0; // Number of bytes read
-		uint8_t tmp[7] = {0}; // temporary buffer to store the 7 bytes representing the date & time
+		if(enable) _control3 |= BIT_U8(CONTROL_3_BTSE);
+		else       _control3 &= ~BIT_U8(CONTROL_3_BTSE);
+	}
 
-		// retrieve date time from RTC
-		br = twiWrapperReadMultipleRegisters(TWI_ADDR, SECONDS, tmp, sizeof(tmp)*sizeof(tmp[0]));
+	/**
+	 * @brief      Read the oscillator stop flag (OSF).
+	 *
+	 * @param      osf   The oscillator stop flag
+	 *
+	 * @return     0 on success or the I2C bus error (see twi_err_t).
+	 */
+	int PCF2129::oscillatorStopped(bool &osf)
+	{
+		METRICS_BEGIN();
+		uint8_t tmp = 0x00;
+		int err = twiTransportReadRegister(TWI_ADDR, SECONDS, &tmp);
+		if(!err) osf = tmp & BIT_U8(SECONDS_OSF);
+		METRICS_END(OP_READ_REGISTER, err, err ? 0 : 1);
+		return err;
+	}
+
+	/**
+	 * @brief      Service the power monitor after /INT has been asserted.
+	 *
+	 * @param      status  The power status to be filled
+	 *
+	 * @return     0 on success or the I2C bus error.
+	 */
+	int PCF2129::servicePowerInterrupt(power_status_t &status)
+	{
+		METRICS_BEGIN();
+		int err = -1;
+		uint8_t bytes = 1; // Number of bytes transferred
+		uint8_t tmp[6] = {0}; // SEC_TIMESTP to YEAR_TIMESTP
 
-		// check if the expected amount of data has been received
-		if(br < sizeof(tmp)*sizeof(tmp[0]))
+		// single status read
+		uint8_t ctl3 = 0x00;
+		err = twiTransportReadRegister(TWI_ADDR, CONTROL_3, &ctl3);
+		if(err)
 		{
-			// something went wrong during the i2c transfer
+			METRICS_END(OP_SERVICE_POWER, err, 0);
 			return err;
 		}
 
-		// convert each received byte of data into decimal format
-		for(uint8_t i=0; i < sizeof(tmp)*sizeof(tmp[0]); i++)
+		status.battery_low     = ctl3 & BIT_U8(CONTROL_3_BLF);
+		status.switchover      = ctl3 & BIT_U8(CONTROL_3_BF);
+		status.timestamp_valid = false;
+
+		if(status.switchover && (_control3 & BIT_U8(CONTROL_3_BTSE)))
 		{
-			tmp[i] = bcd_to_dec(tmp[i]);
+			// retrieve the switch-over time stamp in a single transfer
+			err = twiTransportReadMultipleRegisters(TWI_ADDR, SEC_TIMESTP, tmp, sizeof(tmp));
+			if(err)
+			{
+				// something went wrong during the i2c transfer
+				METRICS_END(OP_SERVICE_POWER, err, bytes);
+				return err;
+			}
+			bytes += sizeof(tmp);
+			status.switchover_ts.sec  = bcd_to_dec(SEC_TIMESTP_FORMAT(tmp[0]));
+			status.switchover_ts.min  = bcd_to_dec(MIN_TIMESTP_FORMAT(tmp[1]));
+			status.switchover_ts.hour = hourDecode(tmp[2]);
+			status.switchover_ts.day  = bcd_to_dec(DAY_TIMESTP_FORMAT(tmp[3]));
+			status.switchover_ts.wday = 0;
+			status.switchover_ts.mon  = bcd_to_dec(MON_TIMESTP_FORMAT(tmp[4]));
+			status.switchover_ts.year = bcd_to_dec(YEAR_TIMESTP_FORMAT(tmp[5]));
+			status.timestamp_valid = true;
 		}
 
-		err = 0x00;
+		// clear BF by writing back the configuration. BLF is read-only and
+		// is cleared by the RTC once the battery has been replaced.
+		if(status.switchover)
+		{
+			err = twiTransportWriteRegister(TWI_ADDR, CONTROL_3, CONTROL_3_FORMAT(_control3) );
+			if(!err) bytes++;
+		}
 
-		// store converted data in datetime structure
-		datetime.sec 	 = tmp[0];
-		datetime.min 	 = tmp[1];
-		datetime.hour	 = tmp[2];
-		datetime.day 	 = tmp[3];
-		datetime.wday	 = tmp[4];
-		datetime.mon 	 = tmp[5];
-		datetime.year 	 = tmp[6];
+		METRICS_END(OP_SERVICE_POWER, err, bytes);
+		return err;
+	}
 
+	/**
+	 * @brief      Read a single BCD register and convert it into decimal format.
+	 *
+	 * @param[in]  reg   The register's address
+	 * @param[out] val   The decimal value. Left untouched on error.
+	 *
+	 * @return     0 on success or the I2C bus error (see twi_err_t).
+	 */
+	int PCF2129::readDecimal(uint8_t reg, uint8_t &val)
+	{
+		METRICS_BEGIN();
+		uint8_t tmp = 0x00;
+		int err = twiTransportReadRegister(TWI_ADDR, reg, &tmp);
+		if(!err) val = bcd_to_dec(tmp);
+		METRICS_END(OP_READ_REGISTER, err, err ? 0 : 1);
+		return err;
+	}
+
+	/**
+	 * @brief      Read the hours register and convert it into 24H format.
+	 *
+	 * @param[out] val   The hours (0 to 23). Left untouched on error.
+	 *
+	 * @return     0 on success or the I2C bus error (see twi_err_t).
+	 */
+	int PCF2129::readHours(uint8_t &val)
+	{
+		METRICS_BEGIN();
+		uint8_t tmp = 0x00;
+		int err = twiTransportReadRegister(TWI_ADDR, HOURS, &tmp);
+		if(!err) val = hourDecode(tmp);
+		METRICS_END(OP_READ_REGISTER, err, err ? 0 : 1);
 		return err;
 	}
 
@@ -16,8 +16,8 @@
 #include <cstdbool>
 
 #include "pcf2129_registers.h"
-#include "rtc_common.hpp"
-#include "twi_wrapper.hpp"
+#include "rtc_device.hpp"
+#include "twi_transport.hpp"
 
 
 namespace RTC
@@ -38,13 +38,76 @@ namespace RTC
         FREQ0HZ         /*< No clkout output and CLKOUT pin remains High Impedance */
     }clkout_freq_t;
 
+    /**
+     * Power management modes. The value of each mode is the
+     * PWRMNG[2:0] field of CONTROL_3. Codes 010, 101 and 110 are
+     * duplicates of the modes below and are not listed.
+     */
+    typedef enum
+    {
+        PWRMNG_STANDARD_BLD     = 0x00, /*< Battery switch-over in standard mode, battery low detection enabled */
+        PWRMNG_STANDARD         = 0x01, /*< Battery switch-over in standard mode, battery low detection disabled */
+        PWRMNG_DIRECT_BLD       = 0x03, /*< Battery switch-over in direct switching mode, battery low detection enabled */
+        PWRMNG_DIRECT           = 0x04, /*< Battery switch-over in direct switching mode, battery low detection disabled */
+        PWRMNG_VDD_ONLY         = 0x07  /*< Battery switch-over disabled (VDD only), battery low detection disabled */
+    }pwrmng_mode_t;
+
+    /**
+     * @brief       Power monitor status retrieved by servicePowerInterrupt().
+     */
+    typedef struct
+    {
+        bool battery_low;       /*< BLF : the battery voltage is below the threshold */
+        bool switchover;        /*< BF  : a battery switch-over occured since last service */
+        bool timestamp_valid;   /*< switchover_ts holds the time of the switch-over (requires BTSE) */
+        DateTime switchover_ts; /*< time of the battery switch-over. wday is not recorded and is set to 0 */
+    }power_status_t;
+
+
+    /**
+     * @brief      PCF2129 register map, resolved at compile time by RTCDevice.
+     */
+    struct PCF2129Map
+    {
+        static constexpr uint8_t TIME_START      = SECONDS;
+        static constexpr uint8_t ALARM_START     = SECOND_ALARM;
+        static constexpr uint8_t ALARM_DISABLE   = SECOND_ALARM_AE_S;   // same bit in every alarm register
+        static constexpr uint8_t TICK_REG        = CONTROL_1;
+        static constexpr uint8_t TICK_SECOND_BIT = CONTROL_1_SI;
+        static constexpr uint8_t TICK_MINUTE_BIT = CONTROL_1_MI;
+        static constexpr uint8_t ALARM_IE_REG    = CONTROL_2;
+        static constexpr uint8_t ALARM_IE_BIT    = CONTROL_2_AIE;
+        static constexpr uint8_t COUNT_MODE_REG  = CONTROL_1;
+        static constexpr uint8_t COUNT_MODE_12H_BIT = CONTROL_1_12_24;
+        static constexpr uint8_t FLAGS_REG       = CONTROL_2;
+        static constexpr uint8_t FLAGS_MASK      = BIT_U8(CONTROL_2_AF) | BIT_U8(CONTROL_2_TSF2) | BIT_U8(CONTROL_2_WDTF) | BIT_U8(CONTROL_2_MSF);
+        static constexpr uint8_t TICK_FLAG_BIT   = CONTROL_2_MSF;
+        static constexpr uint8_t ALARM_FLAG_BIT  = CONTROL_2_AF;
+
+        static constexpr uint8_t timeMask(uint8_t i)
+        {
+            return (uint8_t)(i == 0 ? SECONDS_FORMAT(0xFF)  : i == 1 ? MINUTES_FORMAT(0xFF) :
+                             i == 2 ? HOURS_FORMAT(0xFF)    : i == 3 ? DAYS_FORMAT(0xFF) :
+                             i == 4 ? WEEKDAYS_FORMAT(0xFF) : i == 5 ? MONTHS_FORMAT(0xFF) : YEARS_FORMAT(0xFF));
+        }
+
+        static constexpr uint8_t alarmMask(uint8_t i)
+        {
+            return (uint8_t)(i == 0 ? SECOND_ALARM_FORMAT(0xFF) : i == 1 ? MINUTE_ALARM_FORMAT(0xFF) :
+                             i == 2 ? HOUR_ALARM_FORMAT(0xFF)   : i == 3 ? DAY_ALARM_FORMAT(0xFF) : WEEKDAY_ALARM_FORMAT(0xFF));
+        }
+    };
+
 
     /**
-     * @brief      This class describes a pcf 2129.
+     * @brief      This class describes a pcf 2129. The date and time, alarm
+     *             and tick facilities are inherited from RTCDevice.
      */
-    class PCF2129
+    class PCF2129 : public RTCDevice<PCF2129, PCF2129Map>
     {
 
+        friend class RTCDevice<PCF2129, PCF2129Map>;
+
     public:
 
         const uint8_t TWI_ADDR {0x51}; // The I2C address of PCF2129
@@ -78,18 +141,39 @@ namespace RTC
          */
 
         /**
-         * @brief      Select whether the clock operates in 12H or 24H mode.
+         * @brief      Sets the CLKOUT frequency.
          *
-         * @param[in]  mode  the count mode
+         * @param[in]  clkfreq 	The Clkout clock frequency
          */
-        void selectCountMode(count_mode_t mode);
+        void selectClkoutFreq(clkout_freq_t clkfreq);
 
         /**
-         * @brief      Sets the CLKOUT frequency.
+         * @brief      Select the power management mode (battery switch-over
+         *             and battery low detection).
          *
-         * @param[in]  clkfreq 	The Clkout clock frequency
+         * @param[in]  mode  The power management mode
          */
-        void selectClkoutFreq(clkout_freq_t clkfreq);
+        void selectPowerManagementMode(pwrmng_mode_t mode);
+
+        /**
+         * @brief      Enable or disable the battery interrupts on pin /INT.
+         *             Requesting battery_low also enables the battery low
+         *             detection (PWRMNG_STANDARD_BLD or PWRMNG_DIRECT_BLD),
+         *             which is disabled by default.
+         *
+         * @param[in]  battery_low  Interrupt when the battery low flag (BLF) is set
+         * @param[in]  switchover   Interrupt when the battery switch-over flag (BF) is set
+         */
+        void selectBatteryInterrupts(bool battery_low, bool switchover);
+
+        /**
+         * @brief      Enable or disable the time stamp on battery switch-over (BTSE).
+         *             When enabled, the time stamp registers hold the time of the
+         *             last switch-over and servicePowerInterrupt() reports it.
+         *
+         * @param[in]  enable  The enable
+         */
+        void selectBatterySwitchoverTimestamp(bool enable);
 
 
 
@@ -124,16 +208,6 @@ namespace RTC
 
         // void setTemperatureMeasurementPeriod(uint8_t mode);
         // void setWatchdogTimer();
-        // void setPowerManagementMode(uint8_t flags);
-
-        /**
-         * @brief      Sets the date and the time in the RTC
-         *
-         * @param      datetime  The datetime data to write to the RTC.
-         *
-         * @return     0 on success or the I2C bus error.
-         */
-        int setDateTime(DateTime &datetime);
 
         /*** Getters ***/
 
@@ -141,28 +215,114 @@ namespace RTC
          *  @brief 	Read a single value. Each call to one of the following functions
          *  		perfoms a single read to the I2C bus ie. write the register'address
          *  		to read and then read the value.
+         *  		The value is 0 if the I2C transfer fails.
+         */
+        uint8_t seconds()	{ uint8_t val = 0; readDecimal(SECONDS, val); return val; }
+        uint8_t minutes()	{ uint8_t val = 0; readDecimal(MINUTES, val); return val; }
+        uint8_t hours()		{ uint8_t val = 0; readHours(val); return val; }
+        uint8_t day()		{ uint8_t val = 0; readDecimal(DAYS, val); return val; }
+        uint8_t weekday()	{ uint8_t val = 0; readDecimal(WEEKDAYS, val); return val; }
+        uint8_t month()		{ uint8_t val = 0; readDecimal(MONTHS, val); return val; }
+        uint8_t year()		{ uint8_t val = 0; readDecimal(YEARS, val); return val; }
+
+        /**
+         *  @brief 	Same as above but the I2C bus error is returned (see twi_err_t).
+         *  		The value is left untouched on error.
+         */
+        int seconds(uint8_t &val)	{ return readDecimal(SECONDS, val); }
+        int minutes(uint8_t &val)	{ return readDecimal(MINUTES, val); }
+        int hours(uint8_t &val)		{ return readHours(val); }
+        int day(uint8_t &val)		{ return readDecimal(DAYS, val); }
+        int weekday(uint8_t &val)	{ return readDecimal(WEEKDAYS, val); }
+        int month(uint8_t &val)		{ return readDecimal(MONTHS, val); }
+        int year(uint8_t &val)		{ return readDecimal(YEARS, val); }
+
+        /**
+         * @brief      Read the oscillator stop flag (OSF). When set, the clock
+         *             integrity is not guaranteed : the oscillator has stopped
+         *             since the time was last set. setDateTime() clears it.
+         *
+         * @param      osf   The oscillator stop flag
+         *
+         * @return     0 on success or the I2C bus error (see twi_err_t).
          */
-        uint8_t seconds()	{ return ( bcd_to_dec(twiWrapperReadRegister(TWI_ADDR, SECONDS)) ); }
-        uint8_t minutes()	{ return ( bcd_to_dec(twiWrapperReadRegister(TWI_ADDR, MINUTES)) ); }
-        uint8_t hours()		{ return ( bcd_to_dec(twiWrapperReadRegister(TWI_ADDR, HOURS)) ); }
-        uint8_t day()		{ return ( bcd_to_dec(twiWrapperReadRegister(TWI_ADDR, DAYS)) ); }
-        uint8_t weekday()	{ return ( bcd_to_dec(twiWrapperReadRegister(TWI_ADDR, WEEKDAYS)) ); }
-        uint8_t month()		{ return ( bcd_to_dec(twiWrapperReadRegister(TWI_ADDR, MONTHS)) ); }
-        uint8_t year()		{ return ( bcd_to_dec(twiWrapperReadRegister(TWI_ADDR, YEARS)) ); }
+        int oscillatorStopped(bool &osf);
 
         /**
-         * @brief      Read the date ant time from RTC. The 7 different data registers
-         *  			are read in a single I2C data transfer from the RTC.
-         *  			
-         * @param      datetime  The datetime structure to be filled
+         * @brief      Service the power monitor after /INT has been asserted.
+         *             CONTROL_3 is read once, the switch-over time stamp is
+         *             fetched in a single transfer if a switch-over occured
+         *             with BTSE set, and then BF is cleared.
+         *
+         * @note       Do not call this method from the /INT ISR since it performs
+         *             I2C transfers. Set a flag in the ISR and call it from the
+         *             main loop instead.
+         *
+         * @param      status  The power status to be filled
          *
          * @return     0 on success or the I2C bus error.
          */
-        int dateTime(DateTime &datetime);
+        int servicePowerInterrupt(power_status_t &status);
+
+#if RTC_METRICS_ENABLE
+        /*** Metrics ***/
+
+        /**
+         * @brief      Retrieve the per-operation metrics of this driver
+         *             (calls, failures, bytes, latency histograms and last error).
+         *             Can be called from any context.
+         *
+         * @param      m     The snapshot to be filled
+         */
+        void metrics(metrics_t &m) const
+        {
+            _metrics.snapshot(m);
+            m.bus_retries    = twiTransportStats().retries;
+            m.bus_recoveries = twiTransportStats().recoveries;
+            m.bus_stuck      = twiTransportStats().stuck;
+        }
+
+        /**
+         * @brief      Reset the metrics of this driver.
+         */
+        void resetMetrics() { _metrics.reset(); }
+#endif
 
 
     private:
 
+        /**
+         * @brief      Read a single BCD register and convert it into decimal format.
+         *
+         * @param[in]  reg   The register's address
+         * @param[out] val   The decimal value. Left untouched on error.
+         *
+         * @return     0 on success or the I2C bus error (see twi_err_t).
+         */
+        int readDecimal(uint8_t reg, uint8_t &val);
+
+        /**
+         * @brief      Read the hours register and convert it into 24H format.
+         *
+         * @param[out] val   The hours (0 to 23). Left untouched on error.
+         *
+         * @return     0 on success or the I2C bus error (see twi_err_t).
+         */
+        int readHours(uint8_t &val);
+
+        /**
+         * RTCDevice requirements
+         */
+        int busRead(uint8_t reg, uint8_t* buffer, uint8_t length)		{ return twiTransportReadMultipleRegisters(TWI_ADDR, reg, buffer, length); }
+        int busWrite(uint8_t reg, const uint8_t* data, uint8_t length)	{ return twiTransportWriteMultipleRegisters(TWI_ADDR, reg, data, length); }
+        static uint32_t micros()										{ return twiWrapperMicros(); }
+
+        template<uint8_t reg>
+        uint8_t& shadow()
+        {
+            static_assert(reg == CONTROL_1 || reg == CONTROL_2 || reg == CONTROL_3, "only CONTROL_1 to CONTROL_3 are cached");
+            return (reg == CONTROL_1) ? _control1 : (reg == CONTROL_2) ? _control2 : _control3;
+        }
 
         uint8_t _control1;
         uint8_t _control2;
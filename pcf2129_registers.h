@@ -19,11 +19,7 @@
  *  
  * ******************************* TODO ***************************************
  *
- * - Finish the implementations for alarm macros.
- *   Only the address mapping is implemented. 
- *   The format check and the flags definition has to be done.
- * 
- * - Finish the implementations of watchdog and alarms.
+ * - Finish the implementations of watchdog.
  *   Only the address mapping is implemented. 
  *   The format check and the flags definition has to be done.
  */
@@ -77,7 +73,7 @@ extern "C" {
 /*---------------------------------------------------------------------------*/
 /* Register CONTROL_3                                                        */
 /*---------------------------------------------------------------------------*/
-#define CONTROL_3 				0x03
+#define CONTROL_3 				0x02
 // flags
 #define CONTROL_3_BLIE			0	// Battery Low Interrupt Enable
 #define CONTROL_3_BIE			1	// Battery Interrupt
@@ -87,6 +83,7 @@ extern "C" {
 #define CONTROL_3_PWRMNG_0		5	// Power management mode selection
 #define CONTROL_3_PWRMNG_1		6	//
 #define CONTROL_3_PWRMNG_2		7	//
+#define CONTROL_3_PWRMNG_MASK	0xE0	// PWRMNG[2:0] bits
 #define CONTROL_3_FORMAT(val)	(val)
 
 /*---------------------------------------------------------------------------*/
@@ -186,7 +183,7 @@ extern "C" {
 /* Register DAYS                                                             */
 /*---------------------------------------------------------------------------*/
 #define YEARS 					0x09
-#define MONTHS_FORMAT(val)		(val & 0x1F)	// must not exceed 99
+#define YEARS_FORMAT(val)		(val & 0xFF)	// must not exceed 99
 
 
 
@@ -195,37 +192,46 @@ extern "C" {
 /*---------------------------------------------------------------------------*/
 /* Alarm registers                                                           */
 
-/*** TODO ***
- *
- * Finish the implementations of alarm macros.
- * Only the address mapping is implemented. 
- * The format check and the flags definition has to be done.
- */
-
 /*---------------------------------------------------------------------------*/
 /* Register SECOND_ALARM                                                     */
 /*---------------------------------------------------------------------------*/
 #define SECOND_ALARM 	0x0A
+// flags
+#define SECOND_ALARM_AE_S		7	// Alarm enable, active low
+#define SECOND_ALARM_FORMAT(val)	(val & 0x7F)	// must not exceed 59
 
 /*---------------------------------------------------------------------------*/
 /* Register MINUTE_ALARM                                                     */
 /*---------------------------------------------------------------------------*/
 #define MINUTE_ALARM 	0x0B
+// flags
+#define MINUTE_ALARM_AE_M		7	// Alarm enable, active low
+#define MINUTE_ALARM_FORMAT(val)	(val & 0x7F)	// must not exceed 59
 
 /*---------------------------------------------------------------------------*/
 /* Register HOUR_ALARM                                                       */
 /*---------------------------------------------------------------------------*/
 #define HOUR_ALARM 		0x0C
+// flags
+#define HOUR_ALARM_AMPM		5
+#define HOUR_ALARM_AE_H		7	// Alarm enable, active low
+#define HOUR_ALARM_FORMAT(val)	(val & 0x3F)	// must not exceed 23 in 24h mode
 
 /*---------------------------------------------------------------------------*/
 /* Register DAY_ALARM                                                        */
 /*---------------------------------------------------------------------------*/
 #define DAY_ALARM 		0x0D
+// flags
+#define DAY_ALARM_AE_D		7	// Alarm enable, active low
+#define DAY_ALARM_FORMAT(val)	(val & 0x3F)	// must not exceed 31
 
 /*---------------------------------------------------------------------------*/
 /* Register WEEKDAY_ALARM                                                    */
 /*---------------------------------------------------------------------------*/
 #define WEEKDAY_ALARM 	0x0E
+// flags
+#define WEEKDAY_ALARM_AE_W		7	// Alarm enable, active low
+#define WEEKDAY_ALARM_FORMAT(val)	(val & 0x07)	// must not exceed 6
 
 
 
@@ -251,31 +257,39 @@ extern "C" {
 /* Register SEC_TIMESTP                                                      */
 /*---------------------------------------------------------------------------*/
 #define SEC_TIMESTP		0x13
+#define SEC_TIMESTP_FORMAT(val)	(val & 0x7F)	// must not exceed 59
 
 /*---------------------------------------------------------------------------*/
 /* Register MIN_TIMESTP                                                      */
 /*---------------------------------------------------------------------------*/
 #define MIN_TIMESTP		0x14
+#define MIN_TIMESTP_FORMAT(val)	(val & 0x7F)	// must not exceed 59
 
 /*---------------------------------------------------------------------------*/
 /* Register HOUR_TIMESTP                                                     */
 /*---------------------------------------------------------------------------*/
 #define HOUR_TIMESTP	0x15
+// flags
+#define HOUR_TIMESTP_AMPM		5
+#define HOUR_TIMESTP_FORMAT(val)	(val & 0x3F)	// must not exceed 23 in 24h mode
 
 /*---------------------------------------------------------------------------*/
 /* Register DAY_TIMESTP                                                      */
 /*---------------------------------------------------------------------------*/
 #define DAY_TIMESTP		0x16
+#define DAY_TIMESTP_FORMAT(val)	(val & 0x3F)	// must not exceed 31
 
 /*---------------------------------------------------------------------------*/
 /* Register MON_TIMESTP                                                      */
 /*---------------------------------------------------------------------------*/
 #define MON_TIMESTP		0x17
+#define MON_TIMESTP_FORMAT(val)	(val & 0x1F)	// must not exceed 12
 
 /*---------------------------------------------------------------------------*/
 /* Register YEAR_TIMESTP                                                     */
 /*---------------------------------------------------------------------------*/
 #define YEAR_TIMESTP	0x18
+#define YEAR_TIMESTP_FORMAT(val)	(val & 0xFF)	// must not exceed 99
 
 /*---------------------------------------------------------------------------*/
 /* Register AGING_OFFSET                                                     */
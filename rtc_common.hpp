@@ -12,6 +12,7 @@
 #define RTC_COMMON_HPP 1
 
 #include <cstdint>
+#include <cstddef>
 
 namespace RTC
 {
@@ -59,6 +60,352 @@ namespace RTC
     static inline
     uint8_t dec_to_bcd(uint8_t dec) { return ((dec%10) | ((dec/10)<<4)); }
 
+
+    /**
+     * @brief      Hours register decoding table : the 6 lower bits of an hours
+     *             register (BCD, AM/PM flag in bit 5 in 12h mode) to 0 to 23.
+     *             Selected once with the count mode so that decoding the hours
+     *             does not branch on the mode.
+     *
+     * @param[in]  mode  The count mode
+     *
+     * @return     The 64 entries table
+     */
+    inline
+    const uint8_t* hour_decode_table(count_mode_t mode)
+    {
+        static const uint8_t dec24[64] = {
+            0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+            10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25,
+            20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35,
+            30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45
+        };
+        static const uint8_t dec12[64] = {
+            0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 0, 1, 2, 3,
+            10, 11, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 0, 1,
+            12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 12, 13, 14, 15,
+            22, 23, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 12, 13
+        };
+        return (mode == MODE12H) ? dec12 : dec24;
+    }
+
+    /**
+     * @brief      Hours register encoding table : 0 to 23 to the hours register
+     *             value (BCD, AM/PM flag in bit 5 in 12h mode).
+     *
+     * @param[in]  mode  The count mode
+     *
+     * @return     The 24 entries table
+     */
+    inline
+    const uint8_t* hour_encode_table(count_mode_t mode)
+    {
+        static const uint8_t enc24[24] = {
+            0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x10, 0x11,
+            0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x20, 0x21, 0x22, 0x23
+        };
+        static const uint8_t enc12[24] = {
+            0x12, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x10, 0x11,
+            0x32, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x30, 0x31
+        };
+        return (mode == MODE12H) ? enc12 : enc24;
+    }
+
+    /**
+     * @brief      Day of the week, 0 being sunday (same numbering as the RTC).
+     *
+     * @param[in]  year  The year since 2000 (0 to 99)
+     * @param[in]  mon   The month (1 to 12)
+     * @param[in]  day   The day of the month (1 to 31)
+     *
+     * @return     The weekday (0 to 6)
+     */
+    static inline
+    uint8_t weekday_of(uint8_t year, uint8_t mon, uint8_t day)
+    {
+        static const uint8_t t[12] = {0, 3, 2, 5, 0, 3, 5, 1, 4, 6, 2, 4};
+        uint16_t y = 2000 + year - (mon < 3);
+        return (uint8_t)((y + y/4 - y/100 + y/400 + t[(mon - 1) % 12] + day) % 7);
+    }
+
+
+    /*** Epoch ***
+     *
+     * Seconds since 1970-01-01 00:00:00 UTC (Unix time). A DateTime covers
+     * 2000 to 2099, which fits in 32 bits.
+     */
+
+    constexpr uint32_t EPOCH_2000       = 946684800UL;  /*< 2000-01-01 00:00:00 as Unix time */
+    constexpr uint32_t EPOCH_2100       = 4102444800UL; /*< 2100-01-01 00:00:00 as Unix time, end of the DateTime range */
+    constexpr uint32_t SECONDS_PER_DAY  = 86400UL;
+
+    /**
+     * @brief      Number of days since 2000-01-01.
+     *
+     * @param[in]  year  The year since 2000 (0 to 99)
+     * @param[in]  mon   The month (1 to 12)
+     * @param[in]  day   The day of the month (1 to 31)
+     *
+     * @return     The number of days
+     */
+    static inline
+    uint32_t days_from_civil(uint8_t year, uint8_t mon, uint8_t day)
+    {
+        static const uint16_t before[12] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+        // every year divisible by 4 is a leap year between 2000 and 2099
+        return 365UL * year + (year + 3) / 4 + before[(mon + 11) % 12] + (mon > 2 && (year % 4) == 0) + day - 1;
+    }
+
+    /**
+     * @brief      Convert a date and time to Unix time.
+     *
+     * @param[in]  dt    The date and time
+     *
+     * @return     The number of seconds since 1970-01-01 00:00:00
+     */
+    static inline
+    uint32_t to_epoch(const DateTime &dt)
+    {
+        return EPOCH_2000 + days_from_civil(dt.year, dt.mon, dt.day) * SECONDS_PER_DAY
+               + dt.hour * 3600UL + dt.min * 60UL + dt.sec;
+    }
+
+    /**
+     * @brief      Convert Unix time to a date and time, weekday included.
+     *
+     * @param[in]  epoch  The number of seconds since 1970-01-01 00:00:00,
+     *                    between 2000-01-01 and 2099-12-31
+     * @param      dt     The date and time to be filled
+     */
+    static inline
+    void from_epoch(uint32_t epoch, DateTime &dt)
+    {
+        static const uint8_t mdays[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        uint32_t secs = epoch - EPOCH_2000;
+        uint32_t days = secs / SECONDS_PER_DAY;
+        secs -= days * SECONDS_PER_DAY;
+
+        dt.hour = secs / 3600;
+        dt.min  = (secs / 60) % 60;
+        dt.sec  = secs % 60;
+        dt.wday = (days + 6) % 7; // 2000-01-01 was a saturday
+
+        uint8_t year = days / 366;
+        while(days >= days_from_civil(year + 1, 1, 1)) year++;
+        days -= days_from_civil(year, 1, 1);
+
+        uint8_t mon = 0;
+        while(days >= (uint32_t)(mdays[mon] + (mon == 1 && (year % 4) == 0)))
+        {
+            days -= mdays[mon] + (mon == 1 && (year % 4) == 0);
+            mon++;
+        }
+        dt.year = year;
+        dt.mon  = mon + 1;
+        dt.day  = days + 1;
+    }
+
+
+    /*** Formatting ***
+     *
+     * The formatters write a fixed number of characters followed by a null
+     * byte into a caller provided buffer of at least XXX_LEN + 1 bytes. They
+     * do not depend on the locale and do not allocate.
+     */
+
+    constexpr size_t ISO8601_LEN        = 20;   /*< "2020-09-03T12:34:56Z" */
+    constexpr size_t RFC3339_LEN        = 25;   /*< "2020-09-03T12:34:56+02:00" */
+    constexpr size_t COMPACT_LEN        = 16;   /*< "20200903T123456Z" (ISO 8601 basic format) */
+
+    /**
+     * @brief      Two digits lookup table : "00", "01", ... "99".
+     */
+    inline
+    const char* digits2()
+    {
+        static const char lut[201] = "00010203040506070809101112131415161718192021222324252627282930313233343536373839404142434445464748495051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+        return lut;
+    }
+
+    /**
+     * @brief      Write a value on two digits. Values above 99 are taken modulo 100.
+     */
+    static inline
+    void put2(char* p, uint8_t v)
+    {
+        const char* d = &digits2()[(v % 100) * 2];
+        p[0] = d[0];
+        p[1] = d[1];
+    }
+
+    /**
+     * @brief      Format a date and time as ISO 8601 / RFC 3339 UTC :
+     *             "YYYY-MM-DDThh:mm:ssZ".
+     *
+     * @param[in]  dt    The date and time
+     * @param      buf   The destination buffer, at least ISO8601_LEN + 1 bytes
+     *
+     * @return     ISO8601_LEN
+     */
+    static inline
+    size_t format_iso8601(const DateTime &dt, char* buf)
+    {
+        buf[0] = '2'; buf[1] = '0'; put2(&buf[2], dt.year);
+        buf[4] = '-'; put2(&buf[5], dt.mon);
+        buf[7] = '-'; put2(&buf[8], dt.day);
+        buf[10] = 'T'; put2(&buf[11], dt.hour);
+        buf[13] = ':'; put2(&buf[14], dt.min);
+        buf[16] = ':'; put2(&buf[17], dt.sec);
+        buf[19] = 'Z';
+        buf[20] = '\0';
+        return ISO8601_LEN;
+    }
+
+    /**
+     * @brief      Format a local date and time as RFC 3339 with its UTC offset :
+     *             "YYYY-MM-DDThh:mm:ss+hh:mm".
+     *
+     * @param[in]  dt      The local date and time
+     * @param[in]  offset  The offset to UTC in minutes (-1439 to 1439)
+     * @param      buf     The destination buffer, at least RFC3339_LEN + 1 bytes
+     *
+     * @return     RFC3339_LEN
+     */
+    static inline
+    size_t format_rfc3339(const DateTime &dt, int16_t offset, char* buf)
+    {
+        format_iso8601(dt, buf);
+        buf[19] = (offset < 0) ? '-' : '+';
+        if(offset < 0) offset = -offset;
+        put2(&buf[20], (uint8_t)(offset / 60));
+        buf[22] = ':'; put2(&buf[23], (uint8_t)(offset % 60));
+        buf[25] = '\0';
+        return RFC3339_LEN;
+    }
+
+    /**
+     * @brief      Format a date and time in the compact log format (ISO 8601
+     *             basic format) : "YYYYMMDDThhmmssZ".
+     *
+     * @param[in]  dt    The date and time
+     * @param      buf   The destination buffer, at least COMPACT_LEN + 1 bytes
+     *
+     * @return     COMPACT_LEN
+     */
+    static inline
+    size_t format_compact(const DateTime &dt, char* buf)
+    {
+        buf[0] = '2'; buf[1] = '0'; put2(&buf[2], dt.year);
+        put2(&buf[4], dt.mon);
+        put2(&buf[6], dt.day);
+        buf[8] = 'T'; put2(&buf[9], dt.hour);
+        put2(&buf[11], dt.min);
+        put2(&buf[13], dt.sec);
+        buf[15] = 'Z';
+        buf[16] = '\0';
+        return COMPACT_LEN;
+    }
+
+
+    /*** Parsing ***
+     *
+     * The parsers accept the formats written by the formatters. Years must
+     * be in 2000 to 2099. The weekday is computed from the date.
+     */
+
+    /**
+     * @brief      Read two digits.
+     *
+     * @return     The value or -1 if p does not point to two digits.
+     */
+    static inline
+    int get2(const char* p)
+    {
+        uint8_t a = (uint8_t)(p[0] - '0'), b = (uint8_t)(p[1] - '0');
+        return (a > 9 || b > 9) ? -1 : a * 10 + b;
+    }
+
+    /**
+     * @brief      Check the ranges of a parsed date and time and compute its weekday.
+     *
+     * @return     0 if valid, -1 otherwise.
+     */
+    static inline
+    int datetime_validate(const int f[7], DateTime &dt)
+    {
+        static const uint8_t mdays[12] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        // f : century, year, month, day, hour, minutes, seconds
+        for(uint8_t i=0; i < 7; i++) if(f[i] < 0) return -1;
+        if(f[0] != 20 || f[2] < 1 || f[2] > 12 || f[3] < 1 || f[3] > mdays[f[2] - 1]
+           || (f[2] == 2 && f[3] == 29 && (f[1] % 4)) || f[4] > 23 || f[5] > 59 || f[6] > 59) return -1;
+
+        dt.year = f[1];
+        dt.mon  = f[2];
+        dt.day  = f[3];
+        dt.hour = f[4];
+        dt.min  = f[5];
+        dt.sec  = f[6];
+        dt.wday = weekday_of(dt.year, dt.mon, dt.day);
+        return 0;
+    }
+
+    /**
+     * @brief      Parse an ISO 8601 / RFC 3339 date and time :
+     *             "YYYY-MM-DDThh:mm:ss" followed by "Z" or "+hh:mm" / "-hh:mm".
+     *
+     * @param[in]  str     The string, at least ISO8601_LEN characters
+     * @param      dt      The date and time, as written in the string
+     * @param      offset  If not null, filled with the UTC offset in minutes
+     *
+     * @return     The number of characters parsed or 0 on error.
+     */
+    static inline
+    size_t parse_iso8601(const char* str, DateTime &dt, int16_t* offset = nullptr)
+    {
+        const int f[7] = {get2(&str[0]), get2(&str[2]), get2(&str[5]), get2(&str[8]),
+                          get2(&str[11]), get2(&str[14]), get2(&str[17])};
+        if(str[4] != '-' || str[7] != '-' || (str[10] != 'T' && str[10] != ' ')
+           || str[13] != ':' || str[16] != ':') return 0;
+
+        int off = 0;
+        size_t len = ISO8601_LEN;
+        if(str[19] == '+' || str[19] == '-')
+        {
+            int h = get2(&str[20]), m = (str[22] == ':') ? get2(&str[23]) : -1;
+            if(h < 0 || h > 23 || m < 0 || m > 59) return 0;
+            off = (str[19] == '-') ? -(h * 60 + m) : (h * 60 + m);
+            len = RFC3339_LEN;
+        }
+        else if(str[19] != 'Z') return 0;
+
+        DateTime tmp;
+        if(datetime_validate(f, tmp)) return 0;
+        dt = tmp;
+        if(offset) *offset = (int16_t)off;
+        return len;
+    }
+
+    /**
+     * @brief      Parse a date and time in the compact log format : "YYYYMMDDThhmmssZ".
+     *
+     * @param[in]  str   The string, at least COMPACT_LEN characters
+     * @param      dt    The date and time
+     *
+     * @return     COMPACT_LEN or 0 on error.
+     */
+    static inline
+    size_t parse_compact(const char* str, DateTime &dt)
+    {
+        const int f[7] = {get2(&str[0]), get2(&str[2]), get2(&str[4]), get2(&str[6]),
+                          get2(&str[9]), get2(&str[11]), get2(&str[13])};
+        if(str[8] != 'T' || str[15] != 'Z') return 0;
+
+        DateTime tmp;
+        if(datetime_validate(f, tmp)) return 0;
+        dt = tmp;
+        return COMPACT_LEN;
+    }
+
 };
 
 #endif
\ No newline at end of file
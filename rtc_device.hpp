@@ -0,0 +1,339 @@
+/**
+ * rtc_device.hpp
+ *
+ * Created: 18/10/2026
+ * Author: SCHAAF Hugo
+ * Rev : 0
+ *
+ * RTCDevice is the base of the RTC drivers sharing the NXP PCF212x register
+ * layout : date and time, alarm and tick facilities are implemented once
+ * here and bound at compile time to the chip's register map. Adding a chip
+ * variant only requires a register map and a driver deriving from
+ * RTCDevice<Driver, Map>, without any virtual call.
+ *
+ * The plain date and time helpers are in rtc_common.hpp, which does not
+ * depend on the drivers.
+ */
+
+#ifndef RTC_DEVICE_HPP
+#define RTC_DEVICE_HPP 1
+
+#include <cstdint>
+
+#include "rtc_common.hpp"
+#include "rtc_metrics.hpp"
+
+namespace RTC
+{
+    /**
+     * @brief       Raw content of the time registers, as read in a single
+     *              transfer. Decode it later with RTCDevice::decode().
+     */
+    typedef struct
+    {
+        uint8_t raw[7]; /*< seconds to years registers, BCD */
+    } TimeSnapshot;
+
+    /**
+     * Alarm fields enable bits, see Alarm::enable.
+     */
+    #define ALARM_SEC       0x01
+    #define ALARM_MIN       0x02
+    #define ALARM_HOUR      0x04
+    #define ALARM_DAY       0x08
+    #define ALARM_WDAY      0x10
+
+    /**
+     * @brief       Alarm settings in decimal format. The alarm triggers when
+     *              all the enabled fields match the current date and time.
+     */
+    typedef struct
+    {
+        uint8_t sec;    /*< seconds */
+        uint8_t min;    /*< minutes */
+        uint8_t hour;   /*< hours */
+        uint8_t day;    /*< day */
+        uint8_t wday;   /*< weekday */
+        uint8_t enable; /*< fields taken into account, ALARM_xxx bits */
+    } Alarm;
+
+    /**
+     * @brief      Periodic tick interrupt selection.
+     */
+    typedef enum
+    {
+        TICK_NONE,
+        TICK_SECOND,
+        TICK_MINUTE
+    } tick_t;
+
+
+    /**
+     * @brief      Base of the RTC drivers (CRTP).
+     *
+     *             Derived must provide, accessible to RTCDevice :
+     *             - int busRead(uint8_t reg, uint8_t* buffer, uint8_t length)
+     *             - int busWrite(uint8_t reg, const uint8_t* data, uint8_t length)
+     *             - template<uint8_t reg> uint8_t& shadow() : the cached value of
+     *               a control register, failing to compile for a register it does
+     *               not cache
+     *             - static uint32_t micros()
+     *
+     *             Map is the chip's register map and must provide the
+     *             following compile time constants :
+     *             - TIME_START, ALARM_START : first time and alarm registers
+     *             - timeMask(i), alarmMask(i) : valid bits of the i-th time and alarm register
+     *             - ALARM_DISABLE : alarm register bit disabling the field
+     *             - TICK_REG, TICK_SECOND_BIT, TICK_MINUTE_BIT : tick interrupt selection
+     *             - ALARM_IE_REG, ALARM_IE_BIT : alarm interrupt enable
+     *             - COUNT_MODE_REG, COUNT_MODE_12H_BIT : 12h mode selection
+     *             - FLAGS_REG, FLAGS_MASK, TICK_FLAG_BIT, ALARM_FLAG_BIT : interrupt flags,
+     *               cleared by writing 0, left untouched by writing 1
+     *
+     *             The hours register is the third time and alarm register and
+     *             holds the AM/PM flag in bit 5 in 12h mode.
+     */
+    template<class Derived, class Map>
+    class RTCDevice
+    {
+
+    public:
+
+        /*** Configuration ***
+         *
+         * These methods DO NOT write the RTC's internal registers.
+         * They must be invoked before calling configure().
+         */
+
+        /**
+         * @brief      Select the periodic tick interrupt.
+         *
+         * @param[in]  tick  The tick period
+         */
+        void selectTick(tick_t tick)
+        {
+            uint8_t &reg = derived().template shadow<Map::TICK_REG>();
+            reg &= ~((1 << Map::TICK_SECOND_BIT) | (1 << Map::TICK_MINUTE_BIT));
+            if(tick == TICK_SECOND) reg |= (1 << Map::TICK_SECOND_BIT);
+            if(tick == TICK_MINUTE) reg |= (1 << Map::TICK_MINUTE_BIT);
+        }
+
+        /**
+         * @brief      Select whether the clock operates in 12H or 24H mode. The
+         *             hours are always given in 24H format (0 to 23) by the
+         *             driver whatever the mode.
+         *
+         * @param[in]  mode  The count mode
+         */
+        void selectCountMode(count_mode_t mode)
+        {
+            uint8_t &reg = derived().template shadow<Map::COUNT_MODE_REG>();
+            if(mode == MODE12H) reg |= (1 << Map::COUNT_MODE_12H_BIT);
+            else                reg &= ~(1 << Map::COUNT_MODE_12H_BIT);
+            _hour_decode = hour_decode_table(mode);
+            _hour_encode = hour_encode_table(mode);
+        }
+
+        /**
+         * @brief      Enable or disable the alarm interrupt.
+         *
+         * @param[in]  enable  The enable
+         */
+        void selectAlarmInterrupt(bool enable)
+        {
+            uint8_t &reg = derived().template shadow<Map::ALARM_IE_REG>();
+            if(enable) reg |= (1 << Map::ALARM_IE_BIT);
+            else       reg &= ~(1 << Map::ALARM_IE_BIT);
+        }
+
+
+        /*** Date and time ***/
+
+        /**
+         * @brief      Read the raw time registers in a single I2C data transfer.
+         *
+         * @param      snap  The snapshot to be filled
+         *
+         * @return     0 on success or the I2C bus error (see twi_err_t).
+         */
+        int snapshot(TimeSnapshot &snap)
+        {
+            uint32_t t0 = metricsBegin();
+            int err = derived().busRead(Map::TIME_START, snap.raw, sizeof(snap.raw));
+            metricsEnd(OP_DATETIME, t0, err, err ? 0 : sizeof(snap.raw));
+            return err;
+        }
+
+        /**
+         * @brief      Decode a time registers snapshot.
+         *
+         * @param[in]  snap      The snapshot
+         * @param      datetime  The datetime structure to be filled
+         */
+        void decode(const TimeSnapshot &snap, DateTime &datetime) const
+        {
+            uint8_t* tmp = (uint8_t*)(&datetime);
+            for(uint8_t i=0; i < sizeof(snap.raw); i++)
+            {
+                tmp[i] = bcd_to_dec(snap.raw[i] & Map::timeMask(i));
+            }
+            datetime.hour = hourDecode(snap.raw[2]);
+        }
+
+        /**
+         * @brief      Read the date and time from RTC. The 7 different data registers
+         *             are read in a single I2C data transfer from the RTC.
+         *
+         * @param      datetime  The datetime structure to be filled
+         *
+         * @return     0 on success or the I2C bus error (see twi_err_t).
+         */
+        int dateTime(DateTime &datetime)
+        {
+            TimeSnapshot snap;
+            int err = snapshot(snap);
+            if(!err) decode(snap, datetime);
+            return err;
+        }
+
+        /**
+         * @brief      Sets the date and the time in the RTC. The 7 different data
+         *             registers are written in a single I2C data transfer.
+         *
+         * @param      datetime  The datetime data to write to the RTC.
+         *
+         * @return     0 on success or the I2C bus error (see twi_err_t).
+         */
+        int setDateTime(const DateTime &datetime)
+        {
+            uint32_t t0 = metricsBegin();
+            const uint8_t* src = (const uint8_t*)(&datetime);
+            uint8_t tmp[sizeof(TimeSnapshot::raw)];
+            for(uint8_t i=0; i < sizeof(tmp); i++)
+            {
+                tmp[i] = dec_to_bcd(src[i]) & Map::timeMask(i);
+            }
+            tmp[2] = hourEncode(datetime.hour);
+            int err = derived().busWrite(Map::TIME_START, tmp, sizeof(tmp));
+            metricsEnd(OP_SET_DATETIME, t0, err, err ? 0 : sizeof(tmp));
+            return err;
+        }
+
+
+        /*** Alarm ***/
+
+        /**
+         * @brief      Read the alarm settings in a single I2C data transfer.
+         *
+         * @param      alarm  The alarm to be filled
+         *
+         * @return     0 on success or the I2C bus error (see twi_err_t).
+         */
+        int alarm(Alarm &alarm)
+        {
+            uint8_t tmp[5];
+            int err = derived().busRead(Map::ALARM_START, tmp, sizeof(tmp));
+            if(err) return err;
+
+            uint8_t* dst = (uint8_t*)(&alarm);
+            alarm.enable = 0;
+            for(uint8_t i=0; i < sizeof(tmp); i++)
+            {
+                dst[i] = bcd_to_dec(tmp[i] & Map::alarmMask(i));
+                if(!(tmp[i] & (1 << Map::ALARM_DISABLE))) alarm.enable |= (1 << i);
+            }
+            alarm.hour = hourDecode(tmp[2]);
+            return err;
+        }
+
+        /**
+         * @brief      Write the alarm settings in a single I2C data transfer.
+         *
+         * @param[in]  alarm  The alarm
+         *
+         * @return     0 on success or the I2C bus error (see twi_err_t).
+         */
+        int setAlarm(const Alarm &alarm)
+        {
+            uint8_t tmp[5];
+            const uint8_t* src = (const uint8_t*)(&alarm);
+            for(uint8_t i=0; i < sizeof(tmp); i++)
+            {
+                tmp[i] = dec_to_bcd(src[i]) & Map::alarmMask(i);
+                if(!(alarm.enable & (1 << i))) tmp[i] |= (1 << Map::ALARM_DISABLE);
+            }
+            tmp[2] = hourEncode(alarm.hour) | (tmp[2] & (1 << Map::ALARM_DISABLE));
+            return derived().busWrite(Map::ALARM_START, tmp, sizeof(tmp));
+        }
+
+        /**
+         * @brief      Acknowledge the alarm interrupt (clear the alarm flag).
+         *
+         * @return     0 on success or the I2C bus error (see twi_err_t).
+         */
+        int clearAlarm() { return clearFlag(Map::ALARM_FLAG_BIT); }
+
+        /**
+         * @brief      Acknowledge the tick interrupt (clear the tick flag).
+         *
+         * @return     0 on success or the I2C bus error (see twi_err_t).
+         */
+        int clearTick() { return clearFlag(Map::TICK_FLAG_BIT); }
+
+    protected:
+
+        Derived& derived() { return *static_cast<Derived*>(this); }
+
+        /**
+         * @brief      Clear one interrupt flag, leaving the other ones untouched.
+         */
+        int clearFlag(uint8_t bit)
+        {
+            uint8_t val = (derived().template shadow<Map::FLAGS_REG>() | Map::FLAGS_MASK) & ~(1 << bit);
+            return derived().busWrite(Map::FLAGS_REG, &val, 1);
+        }
+
+        /**
+         * @brief      Convert an hours register (time, alarm or timestamp) to 0 to 23.
+         */
+        uint8_t hourDecode(uint8_t raw) const { return _hour_decode[raw & 0x3F]; }
+
+        /**
+         * @brief      Convert 0 to 23 to an hours register value in the current
+         *             count mode. Hours above 23 are taken modulo 24.
+         */
+        uint8_t hourEncode(uint8_t hour) const { return _hour_encode[hour % 24]; }
+
+        /**
+         * Metrics helpers. Compiled out if RTC_METRICS_ENABLE is 0.
+         */
+        uint32_t metricsBegin() const
+        {
+#if RTC_METRICS_ENABLE
+            return Derived::micros();
+#else
+            return 0;
+#endif
+        }
+
+        void metricsEnd(op_t op, uint32_t t0, int err, uint32_t bytes)
+        {
+#if RTC_METRICS_ENABLE
+            _metrics.record(op, Derived::micros() - t0, err, bytes);
+#else
+            (void)op; (void)t0; (void)err; (void)bytes;
+#endif
+        }
+
+        const uint8_t* _hour_decode = hour_decode_table(MODE24H);  // selected by selectCountMode()
+        const uint8_t* _hour_encode = hour_encode_table(MODE24H);
+
+#if RTC_METRICS_ENABLE
+        Metrics _metrics;
+#endif
+    };
+
+
+};
+
+#endif // RTC_DEVICE_HPP
@@ -0,0 +1,251 @@
+/**
+ * rtc_localtime.cpp
+ *
+ * Created: 18/10/2026
+ * Author: SCHAAF Hugo
+ * Rev : 0
+ *
+ * Local time on top of the UTC kept by the RTC. See rtc_localtime.hpp.
+ */
+
+#include "rtc_localtime.hpp"
+
+namespace RTC {
+
+	/*** POSIX TZ string parsing ***/
+
+	static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+	static bool isAlpha(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+
+	/**
+	 * @brief      Parse a time zone name : at least 3 letters or <...>.
+	 *
+	 * @return     The next character or nullptr on error.
+	 */
+	static const char* parseName(const char* p)
+	{
+		const char* start = p;
+
+		if(*p == '<')
+		{
+			while(*p && *p != '>') p++;
+			return (*p == '>') ? p + 1 : nullptr;
+		}
+		while(isAlpha(*p)) p++;
+		return (p - start >= 3) ? p : nullptr;
+	}
+
+	/**
+	 * @brief      Parse a decimal number between 0 and max.
+	 *
+	 * @return     The next character or nullptr on error.
+	 */
+	static const char* parseNumber(const char* p, int32_t &val, int32_t max)
+	{
+		if(!isDigit(*p)) return nullptr;
+		val = 0;
+		while(isDigit(*p))
+		{
+			val = val * 10 + (*p++ - '0');
+			if(val > max) return nullptr;
+		}
+		return p;
+	}
+
+	/**
+	 * @brief      Parse a time : [+-]hh[:mm[:ss]], hh being 0 to 167.
+	 *
+	 * @return     The next character or nullptr on error.
+	 */
+	static const char* parseTime(const char* p, int32_t &secs)
+	{
+		int32_t h, m = 0, s = 0;
+		bool neg = (*p == '-');
+
+		if(*p == '+' || *p == '-') p++;
+		if(!(p = parseNumber(p, h, 167))) return nullptr;
+		if(*p == ':' && !(p = parseNumber(p + 1, m, 59))) return nullptr;
+		if(*p == ':' && !(p = parseNumber(p + 1, s, 59))) return nullptr;
+
+		secs = h * 3600 + m * 60 + s;
+		if(neg) secs = -secs;
+		return p;
+	}
+
+	/**
+	 * @brief      Parse a transition rule : Jn, n or Mm.w.d, optionally
+	 *             followed by /time.
+	 *
+	 * @return     The next character or nullptr on error.
+	 */
+	static const char* parseRule(const char* p, tz_rule_t &rule)
+	{
+		int32_t a, b, c;
+
+		if(*p == 'J')
+		{
+			if(!(p = parseNumber(p + 1, a, 365)) || a < 1) return nullptr;
+			rule.kind = 'J';
+			rule.day = a;
+		}
+		else if(*p == 'M')
+		{
+			if(!(p = parseNumber(p + 1, a, 12)) || a < 1 || *p != '.') return nullptr;
+			if(!(p = parseNumber(p + 1, b, 5)) || b < 1 || *p != '.') return nullptr;
+			if(!(p = parseNumber(p + 1, c, 6))) return nullptr;
+			rule.kind = 'M';
+			rule.mon = a;
+			rule.week = b;
+			rule.day = c;
+		}
+		else
+		{
+			if(!(p = parseNumber(p, a, 365))) return nullptr;
+			rule.kind = 'D';
+			rule.day = a;
+		}
+
+		rule.time = 2 * 3600; // default transition time is 02:00:00
+		if(*p == '/' && !(p = parseTime(p + 1, rule.time))) return nullptr;
+		return p;
+	}
+
+	/**
+	 * @brief      The day a rule applies to, in days since 2000-01-01.
+	 */
+	static uint32_t ruleDay(const tz_rule_t &rule, uint8_t year)
+	{
+		static const uint8_t mdays[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+		bool leap = (year % 4) == 0;
+
+		if(rule.kind == 'J') return days_from_civil(year, 1, 1) + rule.day - 1 + (leap && rule.day >= 60);
+		if(rule.kind == 'D') return days_from_civil(year, 1, 1) + rule.day;
+
+		uint32_t first = days_from_civil(year, rule.mon, 1);
+		uint8_t length = mdays[rule.mon - 1] + (leap && rule.mon == 2);
+		uint8_t wday = (first + 6) % 7; // 2000-01-01 was a saturday
+		uint8_t day = (rule.day + 7 - wday) % 7 + (rule.week - 1) * 7; // zero based day of the month
+		while(day >= length) day -= 7; // week 5 is the last one
+		return first + day;
+	}
+
+
+	/*** TimeZone ***/
+
+	TimeZone::TimeZone() :
+		_std_offset(0), _dst_offset(0), _has_dst(false), _southern(false),
+		_rules(), _table(), _after()
+	{}
+
+	/**
+	 * @brief      Parse a POSIX TZ string and compile the transitions table.
+	 */
+	int TimeZone::begin(const char* tz)
+	{
+		const char* p = tz;
+		int32_t std_offset, dst_offset, off;
+		tz_rule_t rules[2];
+		bool has_dst = false;
+
+		// std offset
+		if(!p || !(p = parseName(p)) || !(p = parseTime(p, off))) return -1;
+		std_offset = -off; // POSIX offsets are positive west of Greenwich
+		dst_offset = std_offset + 3600;
+
+		// [dst [offset] [,start[/time],end[/time]]]
+		if(*p)
+		{
+			if(!(p = parseName(p))) return -1;
+			if(*p && *p != ',')
+			{
+				if(!(p = parseTime(p, off))) return -1;
+				dst_offset = -off;
+			}
+			if(*p == ',')
+			{
+				if(!(p = parseRule(p + 1, rules[0])) || *p != ',') return -1;
+				if(!(p = parseRule(p + 1, rules[1]))) return -1;
+			}
+			else
+			{
+				// same default rules as glibc
+				parseRule("M3.2.0", rules[0]);
+				parseRule("M11.1.0", rules[1]);
+			}
+			if(*p) return -1;
+			has_dst = true;
+		}
+
+		_std_offset = std_offset;
+		_dst_offset = dst_offset;
+		_has_dst = has_dst;
+		_southern = false;
+		if(!has_dst) return 0;
+
+		uint32_t tr[2];
+		_rules[0] = rules[0];
+		_rules[1] = rules[1];
+		transitions(RTC_TZ_FIRST_YEAR, tr); // unsorted yet : to DST, back to standard time
+		_southern = tr[1] < tr[0];
+		_after[0] = _southern ? _std_offset : _dst_offset;
+		_after[1] = _southern ? _dst_offset : _std_offset;
+		for(uint8_t i=0; i < RTC_TZ_YEARS; i++)
+		{
+			transitions(RTC_TZ_FIRST_YEAR + i, _table[i]);
+		}
+		return 0;
+	}
+
+	/**
+	 * @brief      Compute the UTC transitions of a year, sorted.
+	 */
+	void TimeZone::transitions(uint8_t year, uint32_t tr[2]) const
+	{
+		// The rules give the local time in force before the transition
+		uint32_t to_dst = EPOCH_2000 + ruleDay(_rules[0], year) * SECONDS_PER_DAY + (uint32_t)(_rules[0].time - _std_offset);
+		uint32_t to_std = EPOCH_2000 + ruleDay(_rules[1], year) * SECONDS_PER_DAY + (uint32_t)(_rules[1].time - _dst_offset);
+
+		tr[0] = _southern ? to_std : to_dst;
+		tr[1] = _southern ? to_dst : to_std;
+	}
+
+	/**
+	 * @brief      The offset of the local time to UTC at a given instant.
+	 */
+	int32_t TimeZone::offset(uint32_t utc) const
+	{
+		if(!_has_dst) return _std_offset;
+
+		uint32_t days = (utc - EPOCH_2000) / SECONDS_PER_DAY;
+		uint8_t year = days / 366;
+		while(days >= days_from_civil(year + 1, 1, 1)) year++;
+
+		uint32_t computed[2];
+		const uint32_t* tr = computed;
+		uint8_t i = year - RTC_TZ_FIRST_YEAR;
+
+		if(i < RTC_TZ_YEARS) tr = _table[i];
+		else transitions(year, computed);
+
+		if(utc < tr[0]) return _after[1];
+		if(utc < tr[1]) return _after[0];
+		return _after[1];
+	}
+
+	/**
+	 * @brief      Convert a UTC date and time to local time.
+	 */
+	int TimeZone::toLocal(const DateTime &utc, DateTime &local, int16_t* offset) const
+	{
+		uint32_t t = to_epoch(utc);
+		int32_t off = this->offset(t);
+
+		// a DateTime can not hold the local time across 2000-01-01 or 2100-01-01
+		if(off < 0 ? t - EPOCH_2000 < (uint32_t)-off : EPOCH_2100 - t <= (uint32_t)off) return -1;
+
+		from_epoch(t + (uint32_t)off, local);
+		if(offset) *offset = (int16_t)(off / 60);
+		return 0;
+	}
+
+};
@@ -0,0 +1,142 @@
+/**
+ * rtc_localtime.hpp
+ *
+ * Created: 18/10/2026
+ * Author: SCHAAF Hugo
+ * Rev : 0
+ *
+ * Local time on top of the UTC kept by the RTC.
+ *
+ * A TimeZone is initialized once from a POSIX TZ string, e.g.
+ * "CET-1CEST,M3.5.0,M10.5.0/3". The daylight saving time rules are then
+ * compiled into a table holding the two UTC transitions of RTC_TZ_YEARS
+ * years starting at 2000 + RTC_TZ_FIRST_YEAR, so that converting UTC to local
+ * time is a year-indexed lookup and two comparisons. Dates outside of the
+ * table are still converted, the transitions being computed from the rules.
+ *
+ * Like DateTime, the local time is limited to 2000-2099 : the UTC instants
+ * whose local time falls out of this range, within a few hours of its
+ * edges, are rejected by toLocal().
+ */
+
+#ifndef RTC_LOCALTIME_HPP
+#define RTC_LOCALTIME_HPP 1
+
+#include <cstdint>
+#include <cstdbool>
+
+#include "rtc_common.hpp"
+
+#ifndef RTC_TZ_FIRST_YEAR
+#define RTC_TZ_FIRST_YEAR   20  /*< First year of the transitions table, since 2000 */
+#endif
+
+#ifndef RTC_TZ_YEARS
+#define RTC_TZ_YEARS        32  /*< Number of years of the transitions table (8 bytes per year) */
+#endif
+
+#if RTC_TZ_FIRST_YEAR + RTC_TZ_YEARS > 100
+#error "The transitions table must not go beyond 2099"
+#endif
+
+
+namespace RTC
+{
+    /**
+     * @brief       Daylight saving time transition rule, as written in a
+     *              POSIX TZ string : Jn, n or Mm.w.d followed by /time.
+     */
+    typedef struct
+    {
+        uint8_t kind;   /*< 'J' (julian day, no february 29th), 'D' (zero based day) or 'M' (month, week, day) */
+        uint8_t mon;    /*< month (1 to 12), 'M' only */
+        uint8_t week;   /*< week of the month (1 to 5, 5 being the last), 'M' only */
+        uint16_t day;   /*< julian or zero based day, or weekday (0 is sunday) for 'M' */
+        int32_t time;   /*< local time of the transition, in seconds from midnight */
+    } tz_rule_t;
+
+
+    /**
+     * @brief      Time zone : UTC offsets and daylight saving time transitions.
+     */
+    class TimeZone
+    {
+
+    public:
+
+        /**
+         * @brief      Constructs a new instance, UTC.
+         */
+        TimeZone();
+
+        /**
+         * @brief      Parse a POSIX TZ string and compile the transitions table.
+         *             e.g. "UTC0", "EST5EDT,M3.2.0,M11.1.0", "<+0545>-5:45".
+         *
+         * @param[in]  tz    The TZ string
+         *
+         * @return     0 on success or -1 if the string is invalid, in which case
+         *             the time zone is left unchanged.
+         */
+        int begin(const char* tz);
+
+        /**
+         * @brief      The offset of the local time to UTC at a given instant.
+         *
+         * @param[in]  utc   The instant, as Unix time
+         *
+         * @return     The offset in seconds, positive east of Greenwich.
+         */
+        int32_t offset(uint32_t utc) const;
+
+        /**
+         * @brief      Tell whether daylight saving time is in force.
+         *
+         * @param[in]  utc   The instant, as Unix time
+         *
+         * @return     true if daylight saving time is in force.
+         */
+        bool isDst(uint32_t utc) const { return _has_dst && offset(utc) == _dst_offset; }
+
+        /**
+         * @brief      Convert a UTC date and time to local time.
+         *
+         * @param[in]  utc     The UTC date and time
+         * @param      local   The local date and time to be filled
+         * @param      offset  If not null, filled with the offset in minutes
+         *                     (see format_rfc3339())
+         *
+         * @return     0 on success or -1 if the local time is before 2000 or
+         *             after 2099, in which case local and offset are left
+         *             untouched.
+         */
+        int toLocal(const DateTime &utc, DateTime &local, int16_t* offset = nullptr) const;
+
+    private:
+
+        /**
+         * @brief      Compute the UTC transitions of a year, sorted as in _table.
+         *
+         * @param[in]  year  The year since 2000
+         * @param      tr    The transitions to DST and back to standard time,
+         *                   as Unix time
+         */
+        void transitions(uint8_t year, uint32_t tr[2]) const;
+
+        int32_t _std_offset;    // seconds, positive east
+        int32_t _dst_offset;    // seconds, positive east
+        bool _has_dst;
+        bool _southern;         // back to standard time before DST in the year
+        tz_rule_t _rules[2];    // to DST, back to standard time
+
+        /**
+         * Per year transitions, sorted : _table[i][0] < _table[i][1]. _after[k]
+         * is the offset in force after _table[i][k].
+         */
+        uint32_t _table[RTC_TZ_YEARS][2];
+        int32_t _after[2];
+    };
+
+};
+
+#endif // RTC_LOCALTIME_HPP
@@ -0,0 +1,242 @@
+/**
+ * rtc_metrics.hpp
+ *
+ * Created: 18/10/2026
+ * Author: SCHAAF Hugo
+ * Rev : 0
+ *
+ * Per-operation metrics of the RTC drivers : calls, failures and bytes
+ * counters, latency histograms and last error.
+ *
+ * The metrics are opt-in : set RTC_METRICS_ENABLE to 1 below (or on the
+ * compiler command line) to compile them into the drivers. They cost a
+ * timestamp read and a few stores per operation, plus the counters RAM.
+ *
+ * The counters are only written by the context calling the driver and
+ * are updated with relaxed atomic loads and stores : no lock, no
+ * read-modify-write instruction. They can be read at any time from any
+ * other context (ISR, another thread) with snapshot().
+ */
+
+#ifndef RTC_METRICS_HPP
+#define RTC_METRICS_HPP 1
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <atomic>
+
+#ifndef RTC_METRICS_ENABLE
+#define RTC_METRICS_ENABLE      0   /*< 1 to compile the metrics in */
+#endif
+
+#define RTC_METRICS_BUCKETS     8   /*< Number of latency histogram buckets */
+
+namespace RTC
+{
+    /**
+     * Instrumented operations.
+     */
+    typedef enum
+    {
+        OP_CONFIGURE,       /*< operations with a latency histogram first */
+        OP_SET_DATETIME,
+        OP_DATETIME,
+        OP_START,
+        OP_STOP,
+        OP_READ_REGISTER,   /*< single register getters */
+        OP_SERVICE_POWER,
+        OP_COUNT
+    } op_t;
+
+    /**
+     * Operations having a latency histogram : OP_CONFIGURE, OP_SET_DATETIME
+     * and OP_DATETIME. They are the first three values of op_t so the
+     * histogram index is the operation itself.
+     */
+    #define RTC_METRICS_HIST_OPS    3
+
+    static_assert(OP_CONFIGURE < RTC_METRICS_HIST_OPS && OP_SET_DATETIME < RTC_METRICS_HIST_OPS && OP_DATETIME < RTC_METRICS_HIST_OPS,
+                  "the operations having a latency histogram must come first in op_t");
+
+    /**
+     * Upper bounds (excluded) of the latency histogram buckets in us.
+     * The last bucket holds everything above.
+     */
+    static const uint32_t RTC_METRICS_BUCKET_US[RTC_METRICS_BUCKETS - 1] = {250, 500, 1000, 2000, 4000, 8000, 16000};
+
+    /**
+     * @brief       Counters of one operation.
+     */
+    typedef struct
+    {
+        uint32_t calls;     /*< number of calls */
+        uint32_t failures;  /*< number of calls which returned an error */
+        uint32_t bytes;     /*< number of bytes transferred on the bus */
+    } op_counters_t;
+
+    /**
+     * @brief       Snapshot of the driver's metrics.
+     */
+    typedef struct
+    {
+        op_counters_t ops[OP_COUNT];                                /*< indexed by op_t */
+        uint32_t latency[RTC_METRICS_HIST_OPS][RTC_METRICS_BUCKETS]; /*< indexed by op_t then bucket */
+        int last_error;                                             /*< last error code, 0 if none */
+        uint8_t last_error_op;                                      /*< operation which returned last_error */
+        uint32_t bus_retries;                                       /*< retried transfers on the bus, all drivers included */
+        uint32_t bus_recoveries;                                    /*< bus recoveries, all drivers included */
+        uint32_t bus_stuck;                                         /*< bus recoveries which failed to release SDA, all drivers included */
+    } metrics_t;
+
+
+    /**
+     * @brief      Metrics storage. Embedded in the drivers.
+     */
+    class Metrics
+    {
+
+    public:
+
+        /**
+         * @brief      Record the outcome of one operation.
+         *
+         * @param[in]  op        The operation
+         * @param[in]  duration  The duration of the operation in us
+         * @param[in]  err       The returned error, 0 on success
+         * @param[in]  bytes     The number of bytes transferred
+         */
+        void record(op_t op, uint32_t duration, int err, uint32_t bytes)
+        {
+            inc(_ops[op].calls, 1);
+            inc(_ops[op].bytes, bytes);
+            if(err)
+            {
+                inc(_ops[op].failures, 1);
+                _last_error.store(err, std::memory_order_relaxed);
+                _last_error_op.store(op, std::memory_order_relaxed);
+            }
+            if(op < RTC_METRICS_HIST_OPS)
+            {
+                uint8_t b = 0;
+                while(b < RTC_METRICS_BUCKETS - 1 && duration >= RTC_METRICS_BUCKET_US[b]) b++;
+                inc(_latency[op][b], 1);
+            }
+        }
+
+        /**
+         * @brief      Copy the metrics.
+         *
+         * @param      m     The snapshot to be filled
+         */
+        void snapshot(metrics_t &m) const
+        {
+            for(uint8_t op=0; op < OP_COUNT; op++)
+            {
+                m.ops[op].calls    = _ops[op].calls.load(std::memory_order_relaxed);
+                m.ops[op].failures = _ops[op].failures.load(std::memory_order_relaxed);
+                m.ops[op].bytes    = _ops[op].bytes.load(std::memory_order_relaxed);
+            }
+            for(uint8_t op=0; op < RTC_METRICS_HIST_OPS; op++)
+            {
+                for(uint8_t b=0; b < RTC_METRICS_BUCKETS; b++)
+                {
+                    m.latency[op][b] = _latency[op][b].load(std::memory_order_relaxed);
+                }
+            }
+            m.last_error    = _last_error.load(std::memory_order_relaxed);
+            m.last_error_op = _last_error_op.load(std::memory_order_relaxed);
+            m.bus_retries    = 0;
+            m.bus_recoveries = 0;
+            m.bus_stuck      = 0;
+        }
+
+        /**
+         * @brief      Reset all the metrics. Must be called from the context
+         *             calling the driver.
+         */
+        void reset()
+        {
+            for(uint8_t op=0; op < OP_COUNT; op++)
+            {
+                _ops[op].calls.store(0, std::memory_order_relaxed);
+                _ops[op].failures.store(0, std::memory_order_relaxed);
+                _ops[op].bytes.store(0, std::memory_order_relaxed);
+            }
+            for(uint8_t op=0; op < RTC_METRICS_HIST_OPS; op++)
+            {
+                for(uint8_t b=0; b < RTC_METRICS_BUCKETS; b++) _latency[op][b].store(0, std::memory_order_relaxed);
+            }
+            _last_error.store(0, std::memory_order_relaxed);
+            _last_error_op.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+
+        /**
+         * @brief      Single writer increment : plain load and store, no RMW.
+         */
+        static void inc(std::atomic<uint32_t> &c, uint32_t n)
+        {
+            c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        struct
+        {
+            std::atomic<uint32_t> calls {0};
+            std::atomic<uint32_t> failures {0};
+            std::atomic<uint32_t> bytes {0};
+        } _ops[OP_COUNT];
+        std::atomic<uint32_t> _latency[RTC_METRICS_HIST_OPS][RTC_METRICS_BUCKETS] {};
+        std::atomic<int> _last_error {0};
+        std::atomic<uint8_t> _last_error_op {0};
+    };
+
+
+    /**
+     * @brief      Export a metrics snapshot as text, one line per operation :
+     *
+     *             <op> calls=<n> failures=<n> bytes=<n> [latency_us=<b0>,...,<b7>]
+     *
+     *             followed by a "last_error=<code> op=<op>" line and a
+     *             "bus retries=<n> recoveries=<n> stuck=<n>" line.
+     *
+     * @param[in]  m     The metrics snapshot
+     * @param      buf   The destination buffer
+     * @param[in]  size  The size of the destination buffer
+     *
+     * @return     The number of characters written (excluding the terminating
+     *             null byte), or the size needed if the buffer is too small.
+     */
+    static inline
+    int metricsToText(const metrics_t &m, char* buf, size_t size)
+    {
+        static const char* const names[OP_COUNT] = {"configure", "setDateTime", "dateTime", "start", "stop", "readRegister", "servicePower"};
+        int len = 0;
+
+        #define RTC_METRICS_PRINT(...) len += snprintf(buf + ((size_t)len < size ? len : size), (size_t)len < size ? size - len : 0, __VA_ARGS__)
+
+        for(uint8_t op=0; op < OP_COUNT; op++)
+        {
+            RTC_METRICS_PRINT("%s calls=%lu failures=%lu bytes=%lu", names[op],
+                              (unsigned long)m.ops[op].calls, (unsigned long)m.ops[op].failures, (unsigned long)m.ops[op].bytes);
+            if(op < RTC_METRICS_HIST_OPS)
+            {
+                for(uint8_t b=0; b < RTC_METRICS_BUCKETS; b++)
+                {
+                    RTC_METRICS_PRINT("%s%lu", b ? "," : " latency_us=", (unsigned long)m.latency[op][b]);
+                }
+            }
+            RTC_METRICS_PRINT("\n");
+        }
+        RTC_METRICS_PRINT("last_error=%d op=%s\n", m.last_error, names[m.last_error_op < OP_COUNT ? m.last_error_op : 0]);
+        RTC_METRICS_PRINT("bus retries=%lu recoveries=%lu stuck=%lu\n", (unsigned long)m.bus_retries, (unsigned long)m.bus_recoveries, (unsigned long)m.bus_stuck);
+
+        #undef RTC_METRICS_PRINT
+
+        return len;
+    }
+
+};
+
+#endif // RTC_METRICS_HPP
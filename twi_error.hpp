@@ -0,0 +1,30 @@
+/**
+ * twi_error.hpp
+ *
+ * Created: 18/10/2026
+ * Author: SCHAAF Hugo
+ * Rev : 0
+ *
+ * Error codes returned by the twi wrapper's functions and the transport.
+ * Codes 1 to 5 are the ones returned by Wire.endTransmission() on Arduino.
+ */
+
+#ifndef TWI_ERROR_HPP
+#define TWI_ERROR_HPP 1
+
+/**
+ * I2C transfer results.
+ */
+typedef enum
+{
+    TWI_OK              = 0,    /*< success */
+    TWI_ERR_TOO_LONG    = 1,    /*< data too long to fit in the transmit buffer */
+    TWI_ERR_NACK_ADDR   = 2,    /*< NACK received on transmit of the address */
+    TWI_ERR_NACK_DATA   = 3,    /*< NACK received on transmit of data */
+    TWI_ERR_BUS         = 4,    /*< other bus error (arbitration lost, bus error) */
+    TWI_ERR_TIMEOUT     = 5,    /*< the transfer did not complete before its deadline */
+    TWI_ERR_SHORT_READ  = 6,    /*< less bytes than requested were received */
+    TWI_ERR_BUS_STUCK   = 7     /*< SDA is still held low after a bus recovery */
+} twi_err_t;
+
+#endif // TWI_ERROR_HPP
@@ -0,0 +1,80 @@
+/**
+ * twi_trace.cpp
+ *
+ * Created: 18/10/2026
+ * Author: SCHAAF Hugo
+ * Rev : 0
+ *
+ * Ring buffer of the I2C transactions tracing. See twi_trace.hpp.
+ */
+
+#include "twi_trace.hpp"
+
+#if TWI_TRACE_ENABLE
+
+#if (TWI_TRACE_DEPTH & (TWI_TRACE_DEPTH - 1)) != 0
+#error "TWI_TRACE_DEPTH must be a power of 2"
+#endif
+
+static twi_trace_record_t _trace[TWI_TRACE_DEPTH];
+static uint16_t _head = 0; // index of the next record to write
+static uint16_t _count = 0; // number of valid records
+
+/**
+ * @brief      Append a record to the ring buffer.
+ */
+void twiTraceRecord(uint8_t addr, uint8_t reg, uint8_t dir, const uint8_t* payload, uint8_t length, uint32_t duration, int err)
+{
+	twi_trace_record_t &rec = _trace[_head];
+
+	if(duration > 0xFFFF) duration = 0xFFFF; // saturate
+
+	rec.addr    = addr;
+	rec.reg     = reg;
+	rec.dir_len = dir | (length & 0x7F);
+	rec.err     = (int8_t)err;
+	rec.dur_lo  = (uint8_t)(duration);
+	rec.dur_hi  = (uint8_t)(duration>>8);
+	for(uint8_t i=0; i < TWI_TRACE_PAYLOAD_MAX; i++)
+	{
+		rec.payload[i] = (i < length) ? payload[i] : 0x00;
+	}
+
+	_head = (_head + 1) & (TWI_TRACE_DEPTH - 1);
+	if(_count < TWI_TRACE_DEPTH) _count++;
+}
+
+/**
+ * @brief      Number of records available in the ring buffer.
+ */
+uint16_t twiTraceCount()
+{
+	return _count;
+}
+
+/**
+ * @brief      Move records out of the ring buffer, oldest first.
+ */
+uint16_t twiTraceRead(twi_trace_record_t* records, uint16_t max)
+{
+	uint16_t n = 0;
+	uint16_t tail = (_head - _count) & (TWI_TRACE_DEPTH - 1); // oldest record
+
+	while(n < max && _count)
+	{
+		records[n++] = _trace[tail];
+		tail = (tail + 1) & (TWI_TRACE_DEPTH - 1);
+		_count--;
+	}
+	return n;
+}
+
+/**
+ * @brief      Drop all the records.
+ */
+void twiTraceClear()
+{
+	_count = 0;
+}
+
+#endif // TWI_TRACE_ENABLE
@@ -0,0 +1,138 @@
+/**
+ * twi_trace.hpp
+ *
+ * Created: 18/10/2026
+ * Author: SCHAAF Hugo
+ * Rev : 0
+ *
+ * Optional I2C transactions tracing. Each transaction issued through
+ * twi_transport.hpp is stored as a compact binary record in a ring buffer.
+ *
+ * Set TWI_TRACE_ENABLE to 1 below (or on the compiler command line) to enable
+ * the tracing. When disabled, the transport calls the twi wrapper directly
+ * and the ring buffer is not even allocated.
+ *
+ * A dump of the trace is made of a twi_trace_header_t followed by the
+ * records, oldest first. It can be fed back to the driver on a host
+ * with the replay tool located in extras/replay.
+ */
+
+#ifndef TWI_TRACE_HPP
+#define TWI_TRACE_HPP 1
+
+#include <cstdint>
+
+#ifndef TWI_TRACE_ENABLE
+#define TWI_TRACE_ENABLE        0   /*< 1 to trace the I2C transactions */
+#endif
+
+#ifndef TWI_TRACE_DEPTH
+#define TWI_TRACE_DEPTH         64  /*< Number of records in the ring buffer. Must be a power of 2 */
+#endif
+
+#define TWI_TRACE_PAYLOAD_MAX   8   /*< Payload bytes stored per record. Longer transfers are truncated */
+
+#define TWI_TRACE_MAGIC         0x54464350UL    /*< "PCFT" */
+#define TWI_TRACE_VERSION       1
+
+/**
+ * Transaction direction, stored in bit 7 of twi_trace_record_t::dir_len
+ */
+#define TWI_TRACE_WRITE         0x00
+#define TWI_TRACE_READ          0x80
+
+
+/**
+ * @brief       One traced I2C transaction. Only made of bytes so that
+ *              the binary layout is the same on every platform.
+ */
+typedef struct
+{
+    uint8_t addr;       /*< slave's address */
+    uint8_t reg;        /*< start register */
+    uint8_t dir_len;    /*< direction (bit 7) | number of bytes requested (bits 6:0) */
+    int8_t  err;        /*< 0 on success or the I2C bus error (see twi_err_t) */
+    uint8_t dur_lo;     /*< transfer duration in us, low byte */
+    uint8_t dur_hi;     /*< transfer duration in us, high byte. Saturated to 0xFFFF */
+    uint8_t payload[TWI_TRACE_PAYLOAD_MAX]; /*< transferred bytes */
+} twi_trace_record_t;
+
+/**
+ * @brief       Header of a trace dump.
+ */
+typedef struct
+{
+    uint8_t magic[4];       /*< TWI_TRACE_MAGIC, little endian */
+    uint8_t version;        /*< TWI_TRACE_VERSION */
+    uint8_t record_size;    /*< sizeof(twi_trace_record_t) */
+    uint8_t count_lo;       /*< number of records following the header, low byte */
+    uint8_t count_hi;       /*< number of records following the header, high byte */
+} twi_trace_header_t;
+
+
+/**
+ * Record accessors
+ */
+static inline uint8_t  twiTraceDir(const twi_trace_record_t &rec)      { return (rec.dir_len & 0x80); }
+static inline uint8_t  twiTraceLength(const twi_trace_record_t &rec)   { return (rec.dir_len & 0x7F); }
+static inline uint16_t twiTraceDuration(const twi_trace_record_t &rec) { return (uint16_t)(rec.dur_lo | (rec.dur_hi<<8)); }
+
+/**
+ * @brief      Fill a trace dump header.
+ *
+ * @param      header  The header to fill
+ * @param[in]  count   The number of records following the header
+ */
+static inline
+void twiTraceMakeHeader(twi_trace_header_t &header, uint16_t count)
+{
+    header.magic[0]    = (uint8_t)(TWI_TRACE_MAGIC);
+    header.magic[1]    = (uint8_t)(TWI_TRACE_MAGIC>>8);
+    header.magic[2]    = (uint8_t)(TWI_TRACE_MAGIC>>16);
+    header.magic[3]    = (uint8_t)(TWI_TRACE_MAGIC>>24);
+    header.version     = TWI_TRACE_VERSION;
+    header.record_size = sizeof(twi_trace_record_t);
+    header.count_lo    = (uint8_t)(count);
+    header.count_hi    = (uint8_t)(count>>8);
+}
+
+
+#if TWI_TRACE_ENABLE
+
+/**
+ * @brief      Append a record to the ring buffer. The oldest record
+ *             is overwritten when the buffer is full.
+ *
+ * @param[in]  addr      The slave's address
+ * @param[in]  reg       The start register
+ * @param[in]  dir       TWI_TRACE_READ or TWI_TRACE_WRITE
+ * @param[in]  payload   The transferred bytes
+ * @param[in]  length    The number of bytes requested
+ * @param[in]  duration  The transfer duration in us
+ * @param[in]  err       0 or the I2C bus error (see twi_err_t)
+ */
+void twiTraceRecord(uint8_t addr, uint8_t reg, uint8_t dir, const uint8_t* payload, uint8_t length, uint32_t duration, int err);
+
+/**
+ * @brief      Number of records available in the ring buffer.
+ */
+uint16_t twiTraceCount();
+
+/**
+ * @brief      Move records out of the ring buffer, oldest first.
+ *
+ * @param      records  The destination buffer
+ * @param[in]  max      The size of the destination buffer in records
+ *
+ * @return     The number of records moved.
+ */
+uint16_t twiTraceRead(twi_trace_record_t* records, uint16_t max);
+
+/**
+ * @brief      Drop all the records.
+ */
+void twiTraceClear();
+
+#endif // TWI_TRACE_ENABLE
+
+#endif // TWI_TRACE_HPP
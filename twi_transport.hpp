@@ -0,0 +1,217 @@
+/**
+ * twi_transport.hpp
+ *
+ * Created: 18/10/2026
+ * Author: SCHAAF Hugo
+ * Rev : 0
+ *
+ * I2C transport used by the drivers. It forwards every transaction
+ * to the twi wrapper and adds the optional layers on top of it :
+ *
+ * - tracing, see twi_trace.hpp.
+ * - retry policy : a failed transfer is retried up to TWI_RETRY_MAX times
+ *   with an exponential backoff, as long as TWI_DEADLINE_US has not elapsed
+ *   since the first attempt. If TWI_RECOVERY_ENABLE is set, the bus is
+ *   recovered (see twiWrapperBusRecover()) before retrying a transfer which
+ *   failed on timeout or bus error. If SDA is still held low afterwards,
+ *   the transfer is not retried and fails with TWI_ERR_BUS_STUCK.
+ *
+ * Both layers are selected at compile time. With the default settings
+ * (no tracing, TWI_RETRY_MAX = 0) the transport is a plain forward to the
+ * twi wrapper.
+ *
+ * The twi wrapper implementation is twi_wrapper.hpp by default. Define
+ * TWI_WRAPPER_HEADER to use another one, e.g. the fake device of the
+ * replay tool on a host :
+ *
+ *	-DTWI_WRAPPER_HEADER='"twi_replay.hpp"'
+ */
+
+#ifndef TWI_TRANSPORT_HPP
+#define TWI_TRANSPORT_HPP 1
+
+#include <cstdint>
+
+#ifdef TWI_WRAPPER_HEADER
+#include TWI_WRAPPER_HEADER
+#else
+#include "twi_wrapper.hpp"
+#endif
+
+#include "twi_error.hpp"
+#include "twi_trace.hpp"
+
+#ifndef TWI_RETRY_MAX
+#define TWI_RETRY_MAX           0       /*< Number of retries of a failed transfer. 0 disables the retry policy */
+#endif
+
+#ifndef TWI_RETRY_BACKOFF_US
+#define TWI_RETRY_BACKOFF_US    100     /*< Delay before the first retry in us, doubled at each retry */
+#endif
+
+#ifndef TWI_RECOVERY_ENABLE
+#define TWI_RECOVERY_ENABLE     0       /*< 1 to recover the bus before retrying after a timeout or a bus error */
+#endif
+
+#ifndef TWI_DEADLINE_US
+#define TWI_DEADLINE_US         100000  /*< No retry is started past this delay after the first attempt */
+#endif
+
+#define TWI_TRANSPORT_TIMED     (TWI_TRACE_ENABLE || TWI_RETRY_MAX > 0)
+
+
+/**
+ * @brief       Transport counters, shared by all the drivers.
+ */
+typedef struct
+{
+    uint32_t retries;       /*< number of retried transfers */
+    uint32_t recoveries;    /*< number of bus recoveries */
+    uint32_t stuck;         /*< number of bus recoveries which failed to release SDA */
+} twi_transport_stats_t;
+
+/**
+ * @brief      The transport counters. Only updated when the retry policy is enabled.
+ */
+inline
+twi_transport_stats_t& twiTransportStats()
+{
+    static twi_transport_stats_t stats = {0, 0, 0};
+    return stats;
+}
+
+/**
+ * @brief      Decide whether a failed transfer is retried. Recover the bus and
+ *             wait for the backoff delay if so.
+ *
+ * @param      err      The error of the failed attempt, set to
+ *                      TWI_ERR_BUS_STUCK if the bus recovery failed
+ * @param[in]  attempt  The index of the failed attempt, starting at 0
+ * @param[in]  t0       The start time of the first attempt in us
+ *
+ * @return     true if the transfer must be retried.
+ */
+static inline
+bool twiTransportRetry(int &err, uint8_t attempt, uint32_t t0)
+{
+#if TWI_RETRY_MAX > 0
+    twi_transport_stats_t &stats = twiTransportStats();
+    uint32_t backoff = (uint32_t)TWI_RETRY_BACKOFF_US << attempt;
+
+    // retrying can not fix a transfer which does not fit in the buffers
+    if(err == TWI_ERR_TOO_LONG || attempt >= TWI_RETRY_MAX) return false;
+    if(twiWrapperMicros() - t0 + backoff > TWI_DEADLINE_US) return false;
+
+#if TWI_RECOVERY_ENABLE
+    if(err == TWI_ERR_TIMEOUT || err == TWI_ERR_BUS)
+    {
+        stats.recoveries++;
+        if(twiWrapperBusRecover())
+        {
+            // no transfer can succeed until the slave releases SDA
+            stats.stuck++;
+            err = TWI_ERR_BUS_STUCK;
+            return false;
+        }
+    }
+#endif
+
+    uint32_t t = twiWrapperMicros();
+    while(twiWrapperMicros() - t < backoff);
+
+    stats.retries++;
+    return true;
+#else
+    (void)err; (void)attempt; (void)t0;
+    return false;
+#endif
+}
+
+/**
+ * @brief      Issue a wrapper call with the retry policy and the tracing.
+ *             Expects err to be declared by the caller.
+ */
+#if TWI_TRACE_ENABLE
+#define TWI_TRANSPORT_TRACE(addr, reg, dir, payload, length, t, err) \
+    twiTraceRecord(addr, reg, dir, payload, length, twiWrapperMicros() - t, err)
+#else
+#define TWI_TRANSPORT_TRACE(addr, reg, dir, payload, length, t, err)
+#endif
+
+#define TWI_TRANSPORT_CALL(call, addr, reg, dir, payload, length)   \
+    do {                                                            \
+        uint32_t t0 = twiWrapperMicros(), t = t0;                   \
+        for(uint8_t attempt=0; ; attempt++)                         \
+        {                                                           \
+            err = call;                                             \
+            TWI_TRANSPORT_TRACE(addr, reg, dir, payload, length, t, err); \
+            (void)t;                                                \
+            if(!err || !twiTransportRetry(err, attempt, t0)) break; \
+            t = twiWrapperMicros();                                 \
+        }                                                           \
+    } while(0)
+
+
+
+
+/**
+ * @brief      Read one byte from slave. See twiWrapperReadRegister().
+ */
+static inline
+int twiTransportReadRegister(uint8_t addr, uint8_t reg, uint8_t* val)
+{
+#if TWI_TRANSPORT_TIMED
+    int err;
+    TWI_TRANSPORT_CALL(twiWrapperReadRegister(addr, reg, val), addr, reg, TWI_TRACE_READ, val, 1);
+    return err;
+#else
+    return twiWrapperReadRegister(addr, reg, val);
+#endif
+}
+
+/**
+ * @brief      Read a sequence of multiple bytes. See twiWrapperReadMultipleRegisters().
+ */
+static inline
+int twiTransportReadMultipleRegisters(uint8_t addr, uint8_t start_reg, uint8_t* buffer, uint8_t length)
+{
+#if TWI_TRANSPORT_TIMED
+    int err;
+    TWI_TRANSPORT_CALL(twiWrapperReadMultipleRegisters(addr, start_reg, buffer, length), addr, start_reg, TWI_TRACE_READ, buffer, length);
+    return err;
+#else
+    return twiWrapperReadMultipleRegisters(addr, start_reg, buffer, length);
+#endif
+}
+
+/**
+ * @brief      Write to a register. See twiWrapperWriteRegister().
+ */
+static inline
+int twiTransportWriteRegister(uint8_t addr, uint8_t reg, uint8_t val)
+{
+#if TWI_TRANSPORT_TIMED
+    int err;
+    TWI_TRANSPORT_CALL(twiWrapperWriteRegister(addr, reg, val), addr, reg, TWI_TRACE_WRITE, &val, 1);
+    return err;
+#else
+    return twiWrapperWriteRegister(addr, reg, val);
+#endif
+}
+
+/**
+ * @brief      Write a sequence of multiple bytes. See twiWrapperWriteMultpileRegisters().
+ */
+static inline
+int twiTransportWriteMultipleRegisters(uint8_t addr, uint8_t start_reg, const uint8_t* data, uint8_t length)
+{
+#if TWI_TRANSPORT_TIMED
+    int err;
+    TWI_TRANSPORT_CALL(twiWrapperWriteMultpileRegisters(addr, start_reg, data, length), addr, start_reg, TWI_TRACE_WRITE, data, length);
+    return err;
+#else
+    return twiWrapperWriteMultpileRegisters(addr, start_reg, data, length);
+#endif
+}
+
+#endif // TWI_TRANSPORT_HPP
@@ -12,6 +12,12 @@
 #include "Arduino.h"
 #include "Wire.h"
 
+#include "twi_error.hpp"
+
+#ifndef TWI_TIMEOUT_US
+#define TWI_TIMEOUT_US      25000   /*< Deadline of a single I2C transfer in us */
+#endif
+
 /**
  * Utility stuffs
  */
@@ -32,7 +38,9 @@
 
 
 /**
- * @brief      Initialize the I2C peripheral.
+ * @brief      Initialize the I2C peripheral. Every transfer is given
+ *             TWI_TIMEOUT_US to complete, after which it fails with
+ *             TWI_ERR_TIMEOUT instead of hanging on a stuck bus.
  *
  * @return     0 on success or the I2C bus error.
  */
@@ -41,29 +49,55 @@ int twiWrapperPeripheralInit()
 {
     int err = 0;
     Wire.begin();
+#if defined(WIRE_HAS_TIMEOUT)
+    Wire.setWireTimeout(TWI_TIMEOUT_US, true); // reset the TWI module on timeout
+#endif
     return err;
 }
 
+/**
+ * @brief      Free running microseconds counter. Used to time the
+ *             I2C transfers when tracing is enabled (see twi_trace.hpp).
+ *
+ * @return     The current value of the microseconds counter.
+ */
+static inline
+uint32_t twiWrapperMicros()
+{
+    return micros();
+}
+
 /**
  * @brief      Read one byte from slave
  *
  * @param[in]  addr  The address of the slave
  * @param[in]  reg   The register's address to read
+ * @param[out] val   The received byte of data
  *
- * @return     The received byte of data
+ * @return     0 on success or the I2C bus error (see twi_err_t).
  */
 static inline 
-uint8_t twiWrapperReadRegister(uint8_t addr, uint8_t reg)
+int twiWrapperReadRegister(uint8_t addr, uint8_t reg, uint8_t* val)
 {
     // Send the address @ which to read
     Wire.beginTransmission(addr);
     Wire.write(reg);
-    Wire.endTransmission(true); // Terminate with a stop condition
+    int err = Wire.endTransmission(true); // Terminate with a stop condition
+    if (err != 0) return err;
 
-    Wire.requestFrom(addr, 1, true); // Request one byte and terminate with a stop condition
+    Wire.requestFrom(addr, (uint8_t)1, (uint8_t)true); // Request one byte and terminate with a stop condition
 
-    if (Wire.available()) return Wire.read();
-    else                  return 0x00;
+#if defined(WIRE_HAS_TIMEOUT)
+    if (Wire.getWireTimeoutFlag())
+    {
+        Wire.clearWireTimeoutFlag();
+        return TWI_ERR_TIMEOUT;
+    }
+#endif
+
+    if (!Wire.available()) return TWI_ERR_SHORT_READ;
+    *val = Wire.read();
+    return TWI_OK;
 }
 
 
@@ -77,27 +111,36 @@ uint8_t twiWrapperReadRegister(uint8_t addr, uint8_t reg)
  * @param[in]  buffer     The buffer in which to store received data
  * @param[in]  length     The length in bytes of the buffer
  *
- * @return     The number of bytes received
+ * @return     0 on success, TWI_ERR_SHORT_READ if less than length bytes
+ *             were received or the I2C bus error (see twi_err_t).
  */
 static inline
-uint8_t twiWrapperReadMultipleRegisters(uint8_t addr, uint8_t start_reg, uint8_t* buffer, uint8_t length)
+int twiWrapperReadMultipleRegisters(uint8_t addr, uint8_t start_reg, uint8_t* buffer, uint8_t length)
 {
     uint8_t br = 0x00; // Number of bytes received
 
     // Send the address @ which to start reading bytes
     Wire.beginTransmission(addr);
     Wire.write(start_reg);
-    Wire.endTransmission(true); // Terminate with a stop condition
+    int err = Wire.endTransmission(true); // Terminate with a stop condition
+    if (err != 0) return err;
 
-    Wire.requestFrom(addr, length, true); // Request length bytes and terminate with a stop condition
+    Wire.requestFrom(addr, length, (uint8_t)true); // Request length bytes and terminate with a stop condition
+
+#if defined(WIRE_HAS_TIMEOUT)
+    if (Wire.getWireTimeoutFlag())
+    {
+        Wire.clearWireTimeoutFlag();
+        return TWI_ERR_TIMEOUT;
+    }
+#endif
 
     // Place received bytes in the buffer
-    br = Wire.available();
-    while(Wire.available())
+    while(Wire.available() && br < length)
     {
-        *(buffer++) = Wire.read();
+        buffer[br++] = Wire.read();
     }
-    return br;
+    return (br < length) ? TWI_ERR_SHORT_READ : TWI_OK;
 }
 
 
@@ -108,7 +151,7 @@ uint8_t twiWrapperReadMultipleRegisters(uint8_t addr, uint8_t start_reg, uint8_t
  * @param[in]  reg   The register's address
  * @param[in]  val   The value to be written
  *
- * @return     0 on success or the I2C bus error.
+ * @return     0 on success or the I2C bus error (see twi_err_t).
  */
 static inline 
 int twiWrapperWriteRegister(uint8_t addr, uint8_t reg, uint8_t val)
@@ -118,11 +161,6 @@ int twiWrapperWriteRegister(uint8_t addr, uint8_t reg, uint8_t val)
     Wire.write(reg);
     Wire.write(val);
     int err = Wire.endTransmission(true); // Terminate with a stop condition
-    if (err != 0)
-    {
-        Serial.print("I2C error : ");
-        Serial.println(err);
-    }
     return err;
 }
 
@@ -136,7 +174,7 @@ int twiWrapperWriteRegister(uint8_t addr, uint8_t reg, uint8_t val)
  * @param[in]  data         The data to be written
  * @param[in]  length       The data length in bytes
  *
- * @return     0 on success or the I2C bus error.
+ * @return     0 on success or the I2C bus error (see twi_err_t).
  */
 static inline
 int twiWrapperWriteMultpileRegisters(uint8_t addr, uint8_t start_reg, const uint8_t* data, uint8_t length)
@@ -146,11 +184,54 @@ int twiWrapperWriteMultpileRegisters(uint8_t addr, uint8_t start_reg, const uint
     Wire.write(start_reg);
     Wire.write(data, length);
     int err = Wire.endTransmission(true); // Terminate with a stop condition
-    if (err != 0)
+    return err;
+}
+
+/**
+ * @brief      Recover a stuck bus : a slave interrupted in the middle of a
+ *             transfer may hold SDA low forever. Up to 9 clocks are issued on
+ *             SCL until the slave releases SDA, then a STOP condition is
+ *             generated and the I2C peripheral is re-initialized.
+ *
+ * @return     0 on success or TWI_ERR_BUS_STUCK if SDA is still held low.
+ */
+static inline
+int twiWrapperBusRecover()
+{
+    const unsigned int half_period_us = 5; // 100kHz
+
+    Wire.end();
+
+    // SCL and SDA are only ever driven low or released (input pulled up) :
+    // the output latch is cleared before a pin is switched to output so
+    // that it never drives a line high against a slave holding it low.
+    pinMode(SDA, INPUT_PULLUP);
+    pinMode(SCL, INPUT_PULLUP);
+    delayMicroseconds(half_period_us);
+
+    for(uint8_t i=0; i < 9 && digitalRead(SDA) == LOW; i++)
     {
-        Serial.print("I2C error : ");
-        Serial.println(err);
+        digitalWrite(SCL, LOW);
+        pinMode(SCL, OUTPUT);
+        delayMicroseconds(half_period_us);
+        pinMode(SCL, INPUT_PULLUP);
+        delayMicroseconds(half_period_us);
     }
+
+    // STOP condition : SDA rising while SCL is high
+    digitalWrite(SCL, LOW);
+    pinMode(SCL, OUTPUT);
+    digitalWrite(SDA, LOW);
+    pinMode(SDA, OUTPUT);
+    delayMicroseconds(half_period_us);
+    pinMode(SCL, INPUT_PULLUP);
+    delayMicroseconds(half_period_us);
+    pinMode(SDA, INPUT_PULLUP);
+    delayMicroseconds(half_period_us);
+
+    int err = (digitalRead(SDA) == LOW) ? TWI_ERR_BUS_STUCK : TWI_OK;
+
+    twiWrapperPeripheralInit();
     return err;
 }
 